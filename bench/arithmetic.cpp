@@ -0,0 +1,70 @@
+#include <lisk/lisk.hpp>
+
+#include <chrono>
+#include <iostream>
+
+template<typename F>
+double time_ms(F &&f)
+{
+	const auto begin = std::chrono::steady_clock::now();
+	f();
+	const auto end = std::chrono::steady_clock::now();
+	return std::chrono::duration<double, std::milli>(end - begin).count();
+}
+
+// Real heavy scripts, build with -Dlisk_real_type=double and with the
+// default to compare.
+const char *const scripts[] = {
+  // Integrate x^2 over [0, 1].
+  R"((begin
+  (define x 0.0)
+  (define total 0.0)
+  (repeat 20000 (begin
+    (define total (+ total (* (* x x) 0.00005)))
+    (define x (+ x 0.00005))))
+  total))",
+
+  // Leibniz series for pi.
+  R"((begin
+  (define k 0.0)
+  (define total 0.0)
+  (repeat 10000 (begin
+    (define total (+ total (/ 4.0 (+ (* 4.0 k) 1.0))))
+    (define total (- total (/ 4.0 (+ (* 4.0 k) 3.0))))
+    (define k (+ k 1.0))))
+  total))",
+
+  // Mixed integer and real operands.
+  R"((begin
+  (define total 0.0)
+  (repeat 20000 (define total (sum total 1 +2 0.5 (product 1.5 2 -1))))
+  total))",
+};
+
+int main()
+{
+#ifdef LISK_REAL_DOUBLE
+	std::cout << "real_t: double";
+#else
+	std::cout << "real_t: long double";
+#endif
+	std::cout << " (number is " << sizeof(lisk::number) << " bytes)\n";
+
+	for (const char *script : scripts)
+	{
+		const auto expr = lisk::parse_source(script);
+
+		lisk::expression tree_result;
+		auto tree_env        = lisk::builtin::default_env();
+		const double tree_ms = time_ms(
+		  [&] { tree_result = lisk::eval(expr, tree_env, true); });
+
+		lisk::expression vm_result;
+		auto vm_env        = lisk::builtin::default_env();
+		const double vm_ms = time_ms(
+		  [&] { vm_result = lisk::bytecode::eval(expr, vm_env, true); });
+
+		std::cout << to_string(tree_result) << ": tree " << tree_ms << "ms, vm "
+		          << vm_ms << "ms\n";
+	}
+}
@@ -0,0 +1,58 @@
+#include <lisk/lisk.hpp>
+
+#include <chrono>
+#include <iostream>
+
+template<typename F>
+double time_ms(F &&f)
+{
+	const auto begin = std::chrono::steady_clock::now();
+	f();
+	const auto end = std::chrono::steady_clock::now();
+	return std::chrono::duration<double, std::milli>(end - begin).count();
+}
+
+// Sum a million numbers with (sum ...) over a list and with array-sum over a
+// numeric array holding the same values, both results must be equal.
+int main()
+{
+	const lisk::string ranges[] = {
+	  "(range +0 1000000 +1)",
+	  "(range 0 1000000 1)",
+	  "(range 0.0 1000000 0.5)",
+	};
+
+	size_t mismatches = 0;
+
+	for (const auto &range : ranges)
+	{
+		auto env = lisk::builtin::default_env();
+
+		// Spell out the sum call so that the timing doesn't include building
+		// the list.
+		lisk::string source = "(sum";
+		const auto values = lisk::eval_string(range, env);
+		for (const auto &it : values.get_list().unwrap())
+			source += " " + to_string(it.value);
+		const auto sum_expr = lisk::parse_source(source + ")");
+
+		lisk::expression list_result;
+		const double list_ms = time_ms(
+		  [&] { list_result = lisk::eval(sum_expr, env, true); });
+
+		lisk::eval_string("(define xs (array " + range + "))", env);
+		const auto array_expr = lisk::parse_source("(array-sum xs)");
+
+		lisk::expression array_result;
+		const double array_ms = time_ms(
+		  [&] { array_result = lisk::eval(array_expr, env, true); });
+
+		if (to_string(list_result) != to_string(array_result)) ++mismatches;
+
+		std::cout << range << ": sum " << to_string(list_result) << " in "
+		          << list_ms << "ms, array-sum " << to_string(array_result)
+		          << " in " << array_ms << "ms\n";
+	}
+
+	return mismatches == 0 ? 0 : 1;
+}
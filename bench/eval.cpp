@@ -0,0 +1,126 @@
+#include <lisk/lisk.hpp>
+
+#include <chrono>
+#include <iostream>
+
+template<typename F>
+double time_ms(F &&f)
+{
+	const auto begin = std::chrono::steady_clock::now();
+	f();
+	const auto end = std::chrono::steady_clock::now();
+	return std::chrono::duration<double, std::milli>(end - begin).count();
+}
+
+// Loop heavy scripts, each one is run by the tree walker, the VM and the
+// closure compiler and must produce the same result.
+const char *const scripts[] = {
+  R"((begin
+  (define i 0)
+  (define total 0)
+  (while (begin
+    (define total (+ total (* i 2)))
+    (define i (+ i 1))
+    (if (zero? (- i 20000)) nil true)))
+  total))",
+
+  R"((begin
+  (define count 0)
+  (repeat 20000 (define count (+ count 1)))
+  count))",
+
+  R"((begin
+  (define fib (lambda (n) (if (zero? n) 0 (if (zero? (- n 1)) 1
+    (+ (fib (- n 1)) (fib (- n 2)))))))
+  (fib 18)))",
+
+  // Runs in constant space without an explicit tail.
+  R"((begin
+  (define count-down (lambda (n acc)
+    (if (zero? n) acc (count-down (- n 1) (+ acc 1)))))
+  (count-down 1000000 0)))",
+};
+
+// A small rule that gets evaluated over and over against the same
+// environment.
+const char rule[] = "(if (zero? (- x 3)) (* y 2) (+ (* x y) (/ y 2)))";
+
+int main()
+{
+	size_t mismatches = 0;
+
+	for (const char *script : scripts)
+	{
+		const auto expr = lisk::parse_source(script);
+
+		lisk::expression tree_result;
+		auto tree_env        = lisk::builtin::default_env();
+		const double tree_ms = time_ms(
+		  [&] { tree_result = lisk::eval(expr, tree_env, true); });
+
+		lisk::expression vm_result;
+		auto vm_env        = lisk::builtin::default_env();
+		const double vm_ms = time_ms(
+		  [&] { vm_result = lisk::bytecode::eval(expr, vm_env, true); });
+
+		lisk::expression closure_result;
+		auto closure_env        = lisk::builtin::default_env();
+		const double closure_ms = time_ms(
+		  [&]
+		  {
+			  closure_result = lisk::compile(expr, closure_env)(closure_env, true);
+		  });
+
+		if (to_string(tree_result) != to_string(vm_result) ||
+		    to_string(tree_result) != to_string(closure_result))
+			++mismatches;
+
+		std::cout << to_string(tree_result) << ": tree " << tree_ms << "ms, vm "
+		          << vm_ms << "ms (" << (tree_ms / vm_ms) << "x), closures "
+		          << closure_ms << "ms (" << (tree_ms / closure_ms) << "x)\n";
+	}
+
+	{
+		constexpr size_t iterations = 100000;
+
+		auto env = lisk::builtin::default_env();
+		env.define_atom("x", lisk::atom{lisk::number{lisk::uint_t(5)}});
+		env.define_atom("y", lisk::atom{lisk::number{lisk::uint_t(8)}});
+
+		const auto expr     = lisk::parse_source(rule);
+		const auto chunk    = lisk::bytecode::compile(expr, env);
+		const auto compiled = lisk::compile(expr, env);
+
+		lisk::expression tree_result, vm_result, closure_result;
+		const double tree_ms = time_ms(
+		  [&]
+		  {
+			  for (size_t i = 0; i < iterations; ++i)
+				  tree_result = lisk::eval(expr, env, true);
+		  });
+		const double vm_ms = time_ms(
+		  [&]
+		  {
+			  for (size_t i = 0; i < iterations; ++i)
+				  vm_result = lisk::bytecode::run(chunk, env, true);
+		  });
+		const double closure_ms = time_ms(
+		  [&]
+		  {
+			  for (size_t i = 0; i < iterations; ++i)
+				  closure_result = compiled(env, true);
+		  });
+
+		if (to_string(tree_result) != to_string(vm_result) ||
+		    to_string(tree_result) != to_string(closure_result))
+			++mismatches;
+
+		std::cout << "rule x" << iterations << ": tree " << tree_ms << "ms, vm "
+		          << vm_ms << "ms (" << (tree_ms / vm_ms) << "x), closures "
+		          << closure_ms << "ms (" << (tree_ms / closure_ms) << "x)\n";
+	}
+
+	std::cout << "mismatches: " << mismatches << "\n";
+
+	return mismatches == 0 ? 0 : 1;
+}
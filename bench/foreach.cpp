@@ -0,0 +1,57 @@
+#include <lisk/lisk.hpp>
+
+#include <chrono>
+#include <iostream>
+
+template<typename F>
+double time_ms(F &&f)
+{
+	const auto begin = std::chrono::steady_clock::now();
+	f();
+	const auto end = std::chrono::steady_clock::now();
+	return std::chrono::duration<double, std::milli>(end - begin).count();
+}
+
+// Iterate a million element list, vector and hash map with foreach. The loop
+// variable must not be defined once the loop is done.
+int main()
+{
+	constexpr size_t count = 1000000;
+
+	auto env = lisk::builtin::default_env();
+	lisk::eval_string("(define l (range 0 " + std::to_string(count) + " 1))",
+	                  env);
+
+	const auto l = env["l"];
+	lisk::vector v;
+	lisk::hash_map m;
+	for (const auto &node : l.get_list().unwrap())
+	{
+		v.push_back(node.value);
+		m.set(node.value.get_atom().unwrap(), node.value);
+	}
+	env.define_expr("v", v);
+	env.define_expr("m", m);
+
+	const std::pair<const char *, const char *> loops[] = {
+	  {"list", "(foreach x l x)"},
+	  {"vector", "(foreach x v x)"},
+	  {"hash map", "(foreach x m x)"},
+	  {"list (summing)", "(foreach x l (define total (+ total x)))"},
+	};
+
+	lisk::eval_string("(define total 0)", env);
+	for (const auto &[name, source] : loops)
+	{
+		const auto expr = lisk::parse_source(source);
+		const double ms = time_ms([&] { lisk::eval(expr, env, true); });
+
+		std::cout << name << ": " << ms << "ms"
+		          << (env.find("x") ? " (LEAKED x)" : "") << "\n";
+	}
+
+	lisk::uint_t total = 0;
+	env["total"] >> total;
+	std::cout << "total " << total
+	          << (total == count * (count - 1) / 2 ? "" : " (MISMATCH)") << "\n";
+}
@@ -0,0 +1,81 @@
+#include <lisk/lisk.hpp>
+
+#include <chrono>
+#include <iostream>
+
+template<typename F>
+double time_ms(F &&f)
+{
+	const auto begin = std::chrono::steady_clock::now();
+	f();
+	const auto end = std::chrono::steady_clock::now();
+	return std::chrono::duration<double, std::milli>(end - begin).count();
+}
+
+// Look symbols up in an association list of (key value) lists, the way
+// scripts emulate maps, and in a hash map with the same entries.
+int main()
+{
+	constexpr size_t lookups = 100000;
+
+	for (size_t count : {10, 100, 1000, 10000})
+	{
+		lak::vector<lisk::symbol> keys;
+		for (size_t i = 0; i < count; ++i)
+			keys.push_back(lisk::symbol(("key" + std::to_string(i)).c_str()));
+
+		auto alist = lisk::shared_list::create();
+		auto end   = alist;
+		lisk::hash_map map;
+		for (size_t i = 0; i < count; ++i)
+		{
+			auto entry         = lisk::shared_list::create();
+			entry.value()      = lisk::atom{keys[i]};
+			entry.next_value() = lisk::atom{lisk::number{lisk::uint_t(i)}};
+			end.next_value()   = entry;
+			++end;
+
+			map.set(lisk::atom{keys[i]},
+			        lisk::atom{lisk::number{lisk::uint_t(i)}});
+		}
+		++alist;
+
+		lisk::uint_t alist_total = 0;
+		const double alist_ms    = time_ms(
+		  [&]
+		  {
+			  for (size_t i = 0; i < lookups; ++i)
+			  {
+				  const auto &key = keys[(i * 7919) % count];
+				  for (const auto &node : alist)
+				  {
+					  const auto &entry = node.value.get_list().unwrap();
+					  const auto &atom  = entry.value().get_atom().unwrap();
+					  if (atom.get_symbol().unwrap() == key)
+					  {
+						  lisk::uint_t value;
+						  entry.next_value() >> value;
+						  alist_total += value;
+						  break;
+					  }
+				  }
+			  }
+		  });
+
+		lisk::uint_t map_total = 0;
+		const double map_ms    = time_ms(
+		  [&]
+		  {
+			  for (size_t i = 0; i < lookups; ++i)
+			  {
+				  lisk::uint_t value;
+				  map.find(lisk::atom{keys[(i * 7919) % count]}).unwrap() >> value;
+				  map_total += value;
+			  }
+		  });
+
+		std::cout << count << " keys: association list " << alist_ms
+		          << "ms, hash map " << map_ms << "ms"
+		          << (alist_total == map_total ? "" : " (MISMATCH)") << "\n";
+	}
+}
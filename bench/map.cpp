@@ -0,0 +1,81 @@
+#include <lisk/lisk.hpp>
+
+#include <chrono>
+#include <iostream>
+
+template<typename F>
+double time_ms(F &&f)
+{
+	const auto begin = std::chrono::steady_clock::now();
+	f();
+	const auto end = std::chrono::steady_clock::now();
+	return std::chrono::duration<double, std::milli>(end - begin).count();
+}
+
+// The per element call that lisk::builtin::map used to make, the lambda is
+// copied out of the callable and every element is evaluated again while its
+// arguments are bound.
+lisk::expression legacy_map(const lisk::shared_list &l,
+                            const lisk::expression &f,
+                            lisk::environment &env)
+{
+	lisk::lambda lf;
+	f >> lf;
+	auto arg    = lisk::shared_list::create();
+	auto result = lisk::shared_list::create();
+	auto end    = result;
+	for (const auto &node : l)
+	{
+		arg.value()      = node.value;
+		end.next_value() = lf(arg, env, true).first;
+		++end;
+	}
+	return ++result;
+}
+
+// Map a lambda over a million element list and vector.
+int main()
+{
+	constexpr size_t count = 1000000;
+
+	auto env = lisk::builtin::default_env();
+	lisk::eval_string("(define l (range 0 " + std::to_string(count) + " 1))",
+	                  env);
+	lisk::eval_string("(define f (lambda (x) (* x 2)))", env);
+
+	lisk::vector v;
+	const auto l = env["l"];
+	for (const auto &node : l.get_list().unwrap()) v.push_back(node.value);
+	env.define_expr("v", v);
+
+	auto total = [](const lisk::expression &result)
+	{
+		lisk::uint_t sum = 0;
+		if_let_ok (const lisk::vector &vec, result.get_vector())
+		{
+			for (const auto &value : vec)
+				if (lisk::uint_t x; value >> x) sum += x;
+		}
+		else if_let_ok (const lisk::shared_list &list, result.get_list())
+		{
+			for (const auto &node : list)
+				if (lisk::uint_t x; node.value >> x) sum += x;
+		}
+		return sum;
+	};
+	const lisk::uint_t expected = count * (count - 1);
+
+	lisk::expression result;
+	const double legacy_ms = time_ms(
+	  [&] { result = legacy_map(l.get_list().unwrap(), env["f"], env); });
+	std::cout << "legacy list: " << legacy_ms << "ms"
+	          << (total(result) == expected ? "" : " (MISMATCH)") << "\n";
+
+	for (const char *source : {"(map l f)", "(map v f)"})
+	{
+		const auto expr = lisk::parse_source(source);
+		const double ms = time_ms([&] { result = lisk::eval(expr, env, true); });
+		std::cout << source << ": " << ms << "ms"
+		          << (total(result) == expected ? "" : " (MISMATCH)") << "\n";
+	}
+}
@@ -0,0 +1,144 @@
+#include <lisk/lisk.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <random>
+
+// The regex based implementation that lisk::scan_number replaced.
+bool legacy_is_numeric(std::string_view token)
+{
+	return std::regex_match(token.begin(), token.end(), lisk::numeric_regex);
+}
+
+lisk::number legacy_parse_number(std::string_view token)
+{
+	std::match_results<std::string_view::const_iterator> match;
+
+	if (!std::regex_match(
+	      token.begin(), token.end(), match, lisk::numeric_regex) ||
+	    match.size() != 9)
+		return std::numeric_limits<lisk::real_t>::signaling_NaN();
+
+	if (match[2].matched)
+	{
+		if (match[3].matched)
+			return lisk::real_t(std::stold(match[2].str() + match[3].str()));
+		else if (match[1].matched)
+			return static_cast<lisk::sint_t>(
+			  std::stoll(match[1].str() + match[2].str(), nullptr, 10));
+		else
+			return static_cast<lisk::uint_t>(
+			  std::stoull(match[2].str(), nullptr, 10));
+	}
+	else if (match[5].matched)
+	{
+		if (match[6].matched)
+			return lisk::real_t(
+			  std::stold("0x" + match[2].str() + match[3].str()));
+		else if (match[4].matched)
+			return static_cast<lisk::sint_t>(
+			  std::stoll(match[4].str() + match[5].str(), nullptr, 16));
+		else
+			return static_cast<lisk::uint_t>(
+			  std::stoull(match[5].str(), nullptr, 16));
+	}
+	else if (match[8].matched)
+	{
+		if (match[7].matched)
+			return static_cast<lisk::sint_t>(
+			  std::stoll(match[7].str() + match[8].str(), nullptr, 2));
+		else
+			return static_cast<lisk::uint_t>(
+			  std::stoull(match[8].str(), nullptr, 2));
+	}
+	else
+		return std::numeric_limits<lisk::real_t>::signaling_NaN();
+}
+
+lak::vector<lisk::string> make_corpus(size_t count)
+{
+	// Mostly symbols, as found in typical scripts, with every numeric form
+	// mixed in. Also includes near misses that must not be classified as
+	// numbers.
+	const char *const samples[] = {
+	  "define", "lambda",   "if",     "begin",   "x",       "n",
+	  "zero?",  "+",        "-",      "*",       "foreach", "my-var",
+	  "0",      "42",       "+42",    "-42",     "3.14",    "-0.5",
+	  "0x1F",   "0XfF",     "-0x10",  "0b1011",  "+0B1",    "0x1.8",
+	  "1.",     ".5",       "0x",     "0b2",     "1e5",     "--1",
+	  "+",      "0x1g",     "12ab",   "0b1.1",   "nil",     "true",
+	};
+
+	std::mt19937 rng(1234);
+	std::uniform_int_distribution<size_t> pick(0, std::size(samples) - 1);
+
+	lak::vector<lisk::string> result;
+	result.reserve(count);
+	for (size_t i = 0; i < count; ++i) result.emplace_back(samples[pick(rng)]);
+	return result;
+}
+
+template<typename F>
+double time_ms(F &&f)
+{
+	const auto begin = std::chrono::steady_clock::now();
+	f();
+	const auto end = std::chrono::steady_clock::now();
+	return std::chrono::duration<double, std::milli>(end - begin).count();
+}
+
+int main()
+{
+	const auto corpus = make_corpus(200000);
+
+	// Check that both implementations classify every token the same.
+	size_t mismatches = 0;
+	for (const auto &token : corpus)
+	{
+		const bool legacy  = legacy_is_numeric(token);
+		const bool scanned = lisk::is_numeric(token);
+		if (legacy != scanned) ++mismatches;
+		if (legacy && scanned && token.find('.') == lisk::string::npos)
+		{
+			const auto a = legacy_parse_number(token);
+			const auto b = lisk::parse_number(token);
+			if (a._value.index() != b._value.index() ||
+			    to_string(a) != to_string(b))
+				++mismatches;
+		}
+	}
+
+	size_t legacy_count = 0;
+	const double legacy_ms = time_ms(
+	  [&]
+	  {
+		  for (const auto &token : corpus)
+			  if (legacy_is_numeric(token))
+			  {
+				  legacy_parse_number(token);
+				  ++legacy_count;
+			  }
+	  });
+
+	size_t scan_count = 0;
+	const double scan_ms = time_ms(
+	  [&]
+	  {
+		  for (const auto &token : corpus)
+			  if_let_ok (lisk::number n, lisk::scan_number(token))
+			  {
+				  (void)n;
+				  ++scan_count;
+			  }
+	  });
+
+	std::cout << "tokens:     " << corpus.size() << "\n"
+	          << "mismatches: " << mismatches << "\n"
+	          << "regex:      " << legacy_ms << "ms (" << legacy_count
+	          << " numbers)\n"
+	          << "scan:       " << scan_ms << "ms (" << scan_count
+	          << " numbers)\n"
+	          << "speedup:    " << (legacy_ms / scan_ms) << "x\n";
+
+	return mismatches == 0 ? 0 : 1;
+}
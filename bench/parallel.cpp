@@ -0,0 +1,84 @@
+#include <lisk/lisk.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+template<typename F>
+double time_ms(F &&f)
+{
+	const auto begin = std::chrono::steady_clock::now();
+	f();
+	const auto end = std::chrono::steady_clock::now();
+	return std::chrono::duration<double, std::milli>(end - begin).count();
+}
+
+// Run pmap and preduce over a million elements with pools of increasing
+// size, each run must match map.
+int main()
+{
+	constexpr size_t count = 1000000;
+
+	auto env = lisk::builtin::default_env();
+	lisk::eval_string("(define l (range 0 " + std::to_string(count) + " 1))",
+	                  env);
+	lisk::eval_string(
+	  "(define f (lambda (x) (begin (define y (* x x)) (+ y (* x 3)))))", env);
+	lisk::eval_string("(define add (lambda (a b) (+ a b)))", env);
+
+	const auto map_expr     = lisk::parse_source("(map l f)");
+	const auto pmap_expr    = lisk::parse_source("(pmap l f)");
+	const auto preduce_expr = lisk::parse_source("(preduce l 0 add)");
+
+	lisk::expression expected;
+	const double map_ms =
+	  time_ms([&] { expected = lisk::eval(map_expr, env, true); });
+	std::cout << "map: " << map_ms << "ms\n";
+
+	const size_t hardware = std::thread::hardware_concurrency();
+	for (size_t threads = 1; threads <= hardware || threads == 1; threads *= 2)
+	{
+		lisk::worker_pool pool(threads);
+		auto *previous = lisk::set_worker_pool(&pool);
+
+		lisk::expression mapped;
+		const double pmap_ms =
+		  time_ms([&] { mapped = lisk::eval(pmap_expr, env, true); });
+
+		lisk::expression reduced;
+		const double preduce_ms =
+		  time_ms([&] { reduced = lisk::eval(preduce_expr, env, true); });
+
+		lisk::set_worker_pool(previous);
+
+		lisk::uint_t total = 0;
+		reduced >> total;
+
+		std::cout << threads << " threads: pmap " << pmap_ms << "ms ("
+		          << map_ms / pmap_ms << "x), preduce " << preduce_ms << "ms"
+		          << (to_string(mapped) == to_string(expected) ? ""
+		                                                        : " (MISMATCH)")
+		          << (total == count * (count - 1) / 2 ? "" : " (MISMATCH)")
+		          << "\n";
+	}
+
+	// Recursive lambdas defined in a copy of the frozen shared environment,
+	// both outside of pmap and in its body, must see themselves.
+	const lisk::string recursive =
+	  "(begin"
+	  " (define fact (lambda (n) (if (zero? n) 1 (* n (fact (- n 1))))))"
+	  " (pmap (range 0 64 1) (lambda (x)"
+	  "  (begin"
+	  "   (define down (lambda (n) (if (zero? n) x (down (- n 1)))))"
+	  "   (+ (fact 5) (down 3))))))";
+	auto plain_env  = lisk::builtin::default_env();
+	auto frozen_env = lisk::builtin::shared_env();
+	const auto plain_result  = lisk::eval_string(recursive, plain_env);
+	const auto frozen_result = lisk::eval_string(recursive, frozen_env);
+	std::cout << "recursion in a frozen environment: "
+	          << (!frozen_result.is_exception() &&
+	                  to_string(frozen_result) == to_string(plain_result)
+	                ? "ok"
+	                : "(MISMATCH) " + to_string(frozen_result))
+	          << "\n";
+}
@@ -0,0 +1,80 @@
+#include <lisk/lisk.hpp>
+
+#include <chrono>
+#include <iostream>
+
+template<typename F>
+double time_ms(F &&f)
+{
+	const auto begin = std::chrono::steady_clock::now();
+	f();
+	const auto end = std::chrono::steady_clock::now();
+	return std::chrono::duration<double, std::milli>(end - begin).count();
+}
+
+// Walk l by value the way eval and list_reader do, copying the list at each
+// step.
+size_t count_by_value(lisk::shared_list l)
+{
+	size_t result = 0;
+	for (; l; ++l)
+	{
+		lisk::shared_list copy = l;
+		if (copy.value().is_atom()) ++result;
+	}
+	return result;
+}
+
+int main()
+{
+#ifdef LISK_SINGLE_THREADED
+	std::cout << "reference counts: single threaded\n";
+#else
+	std::cout << "reference counts: atomic\n";
+#endif
+
+	auto env = lisk::builtin::default_env();
+
+	{
+		const auto l = lisk::eval_string("(range 0 100000 1)", env);
+		lisk::shared_list list;
+		l >> list;
+
+		size_t total          = 0;
+		const double traverse = time_ms(
+		  [&]
+		  {
+			  for (size_t i = 0; i < 100; ++i) total += count_by_value(list);
+		  });
+		std::cout << "list traversal: " << traverse << "ms (" << total
+		          << " nodes)\n";
+	}
+
+	{
+		const auto f = lisk::eval_string("(lambda (x) x)", env);
+		lisk::expression copy;
+		const double lambdas = time_ms(
+		  [&]
+		  {
+			  for (size_t i = 0; i < 1000000; ++i) copy = f;
+		  });
+		std::cout << "lambda copies: " << lambdas << "ms\n";
+	}
+
+	{
+		lisk::eval_string(
+		  "(define fib (lambda (n) (if (zero? n) 0 (if (zero? (- n 1)) 1 "
+		  "(+ (fib (- n 1)) (fib (- n 2)))))))",
+		  env);
+		const auto expr = lisk::parse_source("(fib 18)");
+
+		lisk::expression result;
+		const double eval = time_ms(
+		  [&]
+		  {
+			  for (size_t i = 0; i < 10; ++i) result = lisk::eval(expr, env, true);
+		  });
+		std::cout << "evaluation: " << eval << "ms (" << to_string(result)
+		          << ")\n";
+	}
+}
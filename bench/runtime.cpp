@@ -0,0 +1,81 @@
+#include <lisk/lisk.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+template<typename F>
+double time_ms(F &&f)
+{
+	const auto begin = std::chrono::steady_clock::now();
+	f();
+	const auto end = std::chrono::steady_clock::now();
+	return std::chrono::duration<double, std::milli>(end - begin).count();
+}
+
+const lisk::string script =
+  "(begin"
+  " (define l (range 0 100000 1))"
+  " (define f (lambda (x) (begin (define y (* x x)) (+ y 1))))"
+  " (define total 0)"
+  " (foreach x (map l f) (define total (+ total x)))"
+  " total)";
+
+// Run the same script in an increasing number of runtimes at once, one per
+// thread, and time tearing them down.
+int main()
+{
+	lisk::string expected;
+	{
+		lisk::runtime rt;
+		expected = to_string(rt.eval_string(script));
+	}
+
+	for (size_t runtimes : {1, 2, 4, 8})
+	{
+		lak::vector<lisk::string> results(runtimes);
+		lak::vector<lisk::runtime_stats> stats(runtimes);
+		lak::vector<double> teardown_ms(runtimes);
+
+		const double total_ms = time_ms(
+		  [&]
+		  {
+			  lak::vector<std::thread> threads;
+			  for (size_t i = 0; i < runtimes; ++i)
+				  threads.emplace_back(
+				    [&, i]
+				    {
+					    auto rt    = std::make_unique<lisk::runtime>();
+					    results[i] = to_string(rt->eval_string(script));
+					    stats[i]   = rt->stats();
+					    teardown_ms[i] = time_ms([&] { rt.reset(); });
+				    });
+			  for (auto &thread : threads) thread.join();
+		  });
+
+		bool match = true;
+		for (const auto &result : results) match &= result == expected;
+
+		std::cout << runtimes << " runtimes: " << total_ms << "ms, "
+		          << stats[0].nodes.allocations << " nodes, "
+		          << stats[0].bytes_reserved / 1024 << "KiB reserved, teardown "
+		          << teardown_ms[0] << "ms" << (match ? "" : " (MISMATCH)")
+		          << "\n";
+	}
+
+	lisk::runtime limited({.memory_limit = size_t(1) << 20});
+	const auto result = limited.eval_string("(range 0 1000000 1)");
+	std::cout << "1MiB limit: "
+	          << (result.is_exception() ? to_string(result) : "(NOT LIMITED)")
+	          << "\n";
+
+	// The worker threads' nodes count against the limit too.
+	lisk::runtime limited_threads(
+	  {.threads = 4, .memory_limit = size_t(1) << 20});
+	const auto parallel_result = limited_threads.eval_string(
+	  "(pmap (range 0 1000 1) (lambda (x) (range 0 1000 1)))");
+	std::cout << "1MiB limit, 4 threads: "
+	          << (parallel_result.is_exception() ? to_string(parallel_result)
+	                                             : "(NOT LIMITED)")
+	          << "\n";
+}
@@ -102,8 +102,7 @@ int main()
 			std::cout << "\nlisk$ Goodbye!\n";
 			break;
 		}
-		const auto tokens = lisk::tokenise(string);
-		const auto expr   = lisk::parse(tokens);
+		const auto expr   = lisk::parse_source(string);
 		const auto eval   = lisk::eval(expr, default_env, true);
 		const auto result = to_string(eval);
 		std::cout << "lisk$ " << result << "\n";
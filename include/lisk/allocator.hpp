@@ -0,0 +1,363 @@
+#ifndef LISK_ALLOCATOR_HPP
+#define LISK_ALLOCATOR_HPP
+
+#include <lak/utility.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <utility>
+
+namespace lisk
+{
+#ifdef LISK_SINGLE_THREADED
+	// Reference count for runtimes where lisk values never cross threads.
+	struct ref_count
+	{
+		size_t _count;
+
+		explicit ref_count(size_t count) : _count(count) {}
+
+		void increment() { ++_count; }
+
+		// Returns true when this dropped the last reference.
+		bool decrement() { return --_count == 0; }
+
+		size_t load() const { return _count; }
+
+		bool unique() const { return _count == 1; }
+	};
+#else
+	struct ref_count
+	{
+		std::atomic<size_t> _count;
+
+		explicit ref_count(size_t count) : _count(count) {}
+
+		void increment() { _count.fetch_add(1, std::memory_order_relaxed); }
+
+		// Returns true when this dropped the last reference. If this is the
+		// only reference nobody else can be copying it, so the read-modify-write
+		// is skipped.
+		bool decrement()
+		{
+			return _count.load(std::memory_order_acquire) == 1 ||
+			       _count.fetch_sub(1, std::memory_order_acq_rel) == 1;
+		}
+
+		size_t load() const { return _count.load(std::memory_order_relaxed); }
+
+		// Whether this is the only reference. Acquire, like decrement, so that
+		// anything another thread did through its reference before dropping it
+		// happens before whatever the caller then does in place.
+		bool unique() const
+		{
+			return _count.load(std::memory_order_acquire) == 1;
+		}
+	};
+#endif
+
+	struct allocation_stats
+	{
+		size_t allocations   = 0;
+		size_t deallocations = 0;
+		// Allocations that were served from a free list rather than the heap.
+		size_t reused = 0;
+		// Bytes allocated minus bytes freed by this pool. This goes negative on a
+		// thread that frees more nodes than it allocates.
+		int64_t bytes_in_use = 0;
+		// Bytes held in the free lists.
+		size_t bytes_cached = 0;
+	};
+
+	struct node_list;
+
+	// Puts a node on a node_list, list is null while the node is on none.
+	struct node_link
+	{
+		node_link *prev       = nullptr;
+		node_link *next       = nullptr;
+		lisk::node_list *list = nullptr;
+	};
+
+	// Nodes that lisk::collect_cycles has to be able to find. Nodes can be
+	// removed by any thread, so each list has a lock of its own, which only
+	// the threads sharing the list's allocator contend on.
+	struct node_list
+	{
+		std::mutex mutex;
+		// The nodes are linked in a ring through head.
+		lisk::node_link head;
+		size_t size = 0;
+
+		node_list() { head.prev = head.next = &head; }
+
+		node_list(const node_list &)            = delete;
+		node_list &operator=(const node_list &) = delete;
+
+		void push(lisk::node_link &link);
+		void remove(lisk::node_link &link);
+		// Forget every node without touching them, for when their memory is
+		// about to be freed along with the list.
+		void clear();
+	};
+
+	// Bookkeeping at the front of each node_ptr<T> block, nothing by default.
+	template<typename T>
+	struct node_header
+	{
+	};
+
+	struct lambda;
+
+	namespace impl
+	{
+		void untrack_lambda(lisk::node_header<lisk::lambda> &header);
+	}
+
+	// Lambdas are the roots that lisk::collect_cycles starts from. The ones
+	// that can be part of a cycle are put on the node_list of their allocator
+	// (see lisk::impl::track_lambda), any others are never linked and don't
+	// touch a list when they're destroyed.
+	template<>
+	struct node_header<lisk::lambda>
+	{
+		lisk::node_link link;
+
+		node_header() = default;
+		~node_header()
+		{
+			if (link.list) lisk::impl::untrack_lambda(*this);
+		}
+
+		node_header(const node_header &)            = delete;
+		node_header &operator=(const node_header &) = delete;
+	};
+
+	// Provides the memory for shared_list nodes (see lisk::node_ptr). An
+	// allocator must outlive every node that was allocated from it.
+	struct node_allocator
+	{
+		// The lambdas allocated from this allocator that can be part of a
+		// cycle.
+		lisk::node_list _lambdas;
+
+		// Registers the allocator with lisk::collect_cycles.
+		node_allocator();
+		virtual ~node_allocator();
+
+		node_allocator(const node_allocator &)            = delete;
+		node_allocator &operator=(const node_allocator &) = delete;
+
+		virtual void *allocate(size_t size, size_t align)              = 0;
+		virtual void deallocate(void *ptr, size_t size, size_t align) = 0;
+
+		// Statistics for the nodes allocated and freed through this allocator,
+		// reading them is only safe while no other thread is using it.
+		virtual lisk::allocation_stats stats() const { return {}; }
+	};
+
+	// Carves nodes out of large chunks that are all freed at once when the
+	// arena is destroyed, freed nodes are cached in per size class free lists
+	// until then. Only one thread at a time may allocate from an arena, but
+	// nodes can be freed by any thread. Nodes freed by a thread that doesn't
+	// have the arena selected (see set_node_allocator) go onto a lock free
+	// list, which the allocating thread takes back when it needs them.
+	struct arena_allocator final : lisk::node_allocator
+	{
+		static constexpr size_t chunk_size = size_t(64) << 10;
+		// Nodes up to small_size bytes are rounded up to a multiple of 16,
+		// nodes up to large_size bytes to a power of 2. Larger nodes get
+		// their own allocation.
+		static constexpr size_t small_size = 256;
+		static constexpr size_t large_size = size_t(32) << 10;
+		static constexpr size_t classes    = small_size / 16 + 7;
+
+		struct chunk
+		{
+			chunk *next;
+		};
+
+		struct free_block
+		{
+			free_block *next;
+			size_t size_class;
+		};
+
+		// Header in front of each large node.
+		struct alignas(std::max_align_t) large_block
+		{
+			large_block *prev;
+			large_block *next;
+			size_t size;
+		};
+
+		chunk *_chunks      = nullptr;
+		char *_cursor       = nullptr;
+		char *_end          = nullptr;
+		large_block *_large = nullptr;
+		free_block *_free_lists[classes] = {};
+		std::atomic<free_block *> _remote = nullptr;
+
+		size_t _limit    = 0;
+		size_t _reserved = 0;
+		// The arena whose limit this one counts against, and the bytes that
+		// it and the arenas sharing its limit have reserved.
+		arena_allocator *_limit_owner        = this;
+		std::atomic<size_t> _shared_reserved = 0;
+		// Counts the rounded up size of each node, and nodes freed by other
+		// threads once they've been taken back.
+		lisk::allocation_stats _stats;
+
+		// Allocations fail with std::bad_alloc once the chunks and large
+		// nodes would take more than limit bytes, 0 for no limit.
+		explicit arena_allocator(size_t limit = 0);
+
+		// An arena for another thread, whose chunks and large nodes count
+		// against the limit of shared as well as its own. shared must outlive
+		// it.
+		explicit arena_allocator(arena_allocator &shared);
+
+		// Frees every chunk, whether or not the nodes in it were destroyed.
+		~arena_allocator();
+
+		arena_allocator(const arena_allocator &)            = delete;
+		arena_allocator &operator=(const arena_allocator &) = delete;
+
+		void *allocate(size_t size, size_t align) override;
+		void deallocate(void *ptr, size_t size, size_t align) override;
+
+		// Bytes taken from the heap for chunks and large nodes by this arena.
+		size_t bytes_reserved() const { return _reserved; }
+
+		lisk::allocation_stats stats() const override { return _stats; }
+
+		// Move the nodes freed by other threads onto the free lists.
+		void take_remote();
+
+		void reserve(size_t bytes);
+		// Count bytes against the limit, returns false if they don't fit.
+		bool try_reserve(size_t bytes);
+		void release(size_t bytes);
+		void free_large(large_block *block);
+	};
+
+	// Use alloc for nodes created on this thread, nullptr selects this
+	// thread's node pool (the default). Returns the previous allocator.
+	lisk::node_allocator *set_node_allocator(lisk::node_allocator *alloc);
+
+	// The allocator nodes created on this thread come from, or nullptr for
+	// this thread's node pool.
+	lisk::node_allocator *get_node_allocator();
+
+	// Statistics for this thread's node pool. Nodes from the pool may be freed
+	// by any thread, they are then counted (and cached) by the freeing thread.
+	lisk::allocation_stats node_pool_stats();
+
+	// Return everything cached in this thread's node pool to the heap.
+	void trim_node_pool();
+
+	namespace impl
+	{
+		void *allocate_node(lisk::node_allocator *alloc, size_t size, size_t align);
+		void deallocate_node(lisk::node_allocator *alloc,
+		                     void *ptr,
+		                     size_t size,
+		                     size_t align);
+	}
+
+	// Reference counted pointer to a T that is allocated, along with its
+	// count, from the node allocator that was current when it was made. Used
+	// for shared_list nodes and lambdas. The count is atomic unless
+	// LISK_SINGLE_THREADED is defined.
+	template<typename T>
+	struct node_ptr
+	{
+		struct block : lisk::node_header<T>
+		{
+			lisk::ref_count count;
+			lisk::node_allocator *allocator;
+			T value;
+
+			template<typename... ARGS>
+			block(lisk::node_allocator *alloc, ARGS &&...args)
+			: count(1), allocator(alloc), value(lak::forward<ARGS>(args)...)
+			{
+			}
+		};
+
+		block *_block = nullptr;
+
+		node_ptr() = default;
+		node_ptr(std::nullptr_t) {}
+
+		node_ptr(const node_ptr &other) : _block(other._block)
+		{
+			if (_block) _block->count.increment();
+		}
+
+		node_ptr(node_ptr &&other) : _block(std::exchange(other._block, nullptr))
+		{
+		}
+
+		~node_ptr() { reset(); }
+
+		node_ptr &operator=(const node_ptr &other)
+		{
+			node_ptr(other).swap(*this);
+			return *this;
+		}
+
+		node_ptr &operator=(node_ptr &&other)
+		{
+			node_ptr(lak::move(other)).swap(*this);
+			return *this;
+		}
+
+		template<typename... ARGS>
+		static node_ptr make(ARGS &&...args)
+		{
+			lisk::node_allocator *alloc = lisk::get_node_allocator();
+			void *mem =
+			  lisk::impl::allocate_node(alloc, sizeof(block), alignof(block));
+			node_ptr result;
+			try
+			{
+				result._block = ::new (mem) block(alloc, lak::forward<ARGS>(args)...);
+			}
+			catch (...)
+			{
+				lisk::impl::deallocate_node(alloc, mem, sizeof(block), alignof(block));
+				throw;
+			}
+			return result;
+		}
+
+		void swap(node_ptr &other) { std::swap(_block, other._block); }
+
+		void reset()
+		{
+			block *b = std::exchange(_block, nullptr);
+			if (b && b->count.decrement())
+			{
+				lisk::node_allocator *alloc = b->allocator;
+				b->~block();
+				lisk::impl::deallocate_node(alloc, b, sizeof(block), alignof(block));
+			}
+		}
+
+		size_t use_count() const { return _block ? _block->count.load() : 0; }
+
+		bool unique() const { return _block && _block->count.unique(); }
+
+		T *get() const { return _block ? &_block->value : nullptr; }
+		T &operator*() const { return _block->value; }
+		T *operator->() const { return &_block->value; }
+
+		explicit operator bool() const { return _block; }
+	};
+}
+
+#endif
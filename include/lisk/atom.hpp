@@ -7,6 +7,7 @@
 #	define LISK_POINTER_FORWARD_ONLY
 #	include "lisk/pointer.hpp"
 
+#	include "lisk/box.hpp"
 #	include "lisk/string.hpp"
 
 #	include <lak/result.hpp>
@@ -20,12 +21,15 @@ namespace lisk
 		{
 		};
 
+		// Strings and pointers are boxed, everything else is stored inline, so
+		// an atom is 24 bytes.
 		using value_type = lak::variant<nil,
 		                                lisk::symbol,
-		                                lisk::string,
+		                                lisk::resolved_symbol,
+		                                lisk::box<lisk::string>,
 		                                lisk::number,
 		                                bool,
-		                                lisk::pointer>;
+		                                lisk::box<lisk::pointer>>;
 		value_type _value;
 
 		atom()              = default;
@@ -37,6 +41,7 @@ namespace lisk
 
 		inline atom(nil);
 		inline atom(const lisk::symbol &sym);
+		inline atom(const lisk::resolved_symbol &sym);
 		inline atom(const lisk::string &str);
 		inline atom(const lisk::number &num);
 		inline atom(bool b);
@@ -44,13 +49,17 @@ namespace lisk
 
 		inline atom &operator=(nil);
 		inline atom &operator=(const lisk::symbol &sym);
+		inline atom &operator=(const lisk::resolved_symbol &sym);
 		inline atom &operator=(const lisk::string &str);
 		inline atom &operator=(const lisk::number &num);
 		inline atom &operator=(bool b);
 		inline atom &operator=(const lisk::pointer &ptr);
 
 		inline bool is_nil() const;
+		// Resolved symbols are still symbols, is_symbol and get_symbol see
+		// through them.
 		inline bool is_symbol() const;
+		inline bool is_resolved_symbol() const;
 		inline bool is_string() const;
 		inline bool is_number() const;
 		inline bool is_bool() const;
@@ -60,6 +69,11 @@ namespace lisk
 		inline lak::result<const lisk::symbol &> get_symbol() const &;
 		inline lak::result<lisk::symbol> get_symbol() &&;
 
+		inline lak::result<lisk::resolved_symbol &> get_resolved_symbol() &;
+		inline lak::result<const lisk::resolved_symbol &> get_resolved_symbol()
+		  const &;
+		inline lak::result<lisk::resolved_symbol> get_resolved_symbol() &&;
+
 		inline lak::result<lisk::string &> get_string() &;
 		inline lak::result<const lisk::string &> get_string() const &;
 		inline lak::result<lisk::string> get_string() &&;
@@ -79,13 +93,17 @@ namespace lisk
 		template<typename LAMBDA>
 		auto visit(LAMBDA &&lambda) const
 		{
-			return lak::visit(lambda, _value);
+			return lak::visit([&](auto &v) { return lambda(lisk::unbox(v)); },
+			                  _value);
 		}
 
+		// Boxed values are visited as const, write to them through the get_
+		// accessors.
 		template<typename LAMBDA>
 		auto visit(LAMBDA &&lambda)
 		{
-			return lak::visit(lambda, _value);
+			return lak::visit(
+			  [&](auto &v) { return lambda(lisk::visit_unbox(v)); }, _value);
 		}
 	};
 
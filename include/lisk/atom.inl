@@ -8,9 +8,21 @@
 
 inline lisk::atom::atom(nil) : _value(nil{}) {}
 
-inline lisk::atom::atom(const lisk::symbol &sym) : _value(sym) {}
+inline lisk::atom::atom(const lisk::symbol &sym)
+: _value(lak::in_place_index<value_type::index_of<lisk::symbol>>, sym)
+{
+}
 
-inline lisk::atom::atom(const string &str) : _value(str) {}
+inline lisk::atom::atom(const lisk::resolved_symbol &sym)
+: _value(lak::in_place_index<value_type::index_of<lisk::resolved_symbol>>, sym)
+{
+}
+
+inline lisk::atom::atom(const string &str)
+: _value(lak::in_place_index<value_type::index_of<lisk::box<lisk::string>>>,
+         str)
+{
+}
 
 inline lisk::atom::atom(const number &num) : _value(num) {}
 
@@ -19,7 +31,11 @@ inline lisk::atom::atom(bool b)
 {
 }
 
-inline lisk::atom::atom(const pointer &ptr) : _value(ptr) {}
+inline lisk::atom::atom(const pointer &ptr)
+: _value(lak::in_place_index<value_type::index_of<lisk::box<lisk::pointer>>>,
+         ptr)
+{
+}
 
 /* --- operator= --- */
 
@@ -35,9 +51,15 @@ inline lisk::atom &lisk::atom::operator=(const lisk::symbol &sym)
 	return *this;
 }
 
+inline lisk::atom &lisk::atom::operator=(const lisk::resolved_symbol &sym)
+{
+	_value.emplace<value_type::index_of<lisk::resolved_symbol>>(sym);
+	return *this;
+}
+
 inline lisk::atom &lisk::atom::operator=(const lisk::string &str)
 {
-	_value.emplace<value_type::index_of<lisk::string>>(str);
+	_value.emplace<value_type::index_of<lisk::box<lisk::string>>>(str);
 	return *this;
 }
 
@@ -55,7 +77,7 @@ inline lisk::atom &lisk::atom::operator=(bool b)
 
 inline lisk::atom &lisk::atom::operator=(const lisk::pointer &ptr)
 {
-	_value.emplace<value_type::index_of<lisk::pointer>>(ptr);
+	_value.emplace<value_type::index_of<lisk::box<lisk::pointer>>>(ptr);
 	return *this;
 }
 
@@ -68,12 +90,18 @@ inline bool lisk::atom::is_nil() const
 
 inline bool lisk::atom::is_symbol() const
 {
-	return _value.template holds<lisk::symbol>();
+	return _value.template holds<lisk::symbol>() ||
+	       _value.template holds<lisk::resolved_symbol>();
+}
+
+inline bool lisk::atom::is_resolved_symbol() const
+{
+	return _value.template holds<lisk::resolved_symbol>();
 }
 
 inline bool lisk::atom::is_string() const
 {
-	return _value.template holds<lisk::string>();
+	return _value.template holds<lisk::box<lisk::string>>();
 }
 
 inline bool lisk::atom::is_number() const
@@ -88,39 +116,70 @@ inline bool lisk::atom::is_bool() const
 
 inline bool lisk::atom::is_pointer() const
 {
-	return _value.template holds<lisk::pointer>();
+	return _value.template holds<lisk::box<lisk::pointer>>();
 }
 
 /* --- get_x --- */
 
 inline lak::result<lisk::symbol &> lisk::atom::get_symbol() &
 {
+	if (auto *resolved =
+	      _value.template get<value_type::index_of<lisk::resolved_symbol>>())
+		return lak::result_from_pointer(&resolved->sym);
 	return lak::get<lisk::symbol>(_value);
 }
 
 inline lak::result<const lisk::symbol &> lisk::atom::get_symbol() const &
 {
+	if (const auto *resolved =
+	      _value.template get<value_type::index_of<lisk::resolved_symbol>>())
+		return lak::result_from_pointer(&resolved->sym);
 	return lak::get<lisk::symbol>(_value);
 }
 
 inline lak::result<lisk::symbol> lisk::atom::get_symbol() &&
 {
+	if (auto *resolved =
+	      _value.template get<value_type::index_of<lisk::resolved_symbol>>())
+		return lak::move_result_from_pointer(&resolved->sym);
 	return lak::get<lisk::symbol>(lak::move(_value));
 }
 
+inline lak::result<lisk::resolved_symbol &> lisk::atom::get_resolved_symbol() &
+{
+	return lak::get<lisk::resolved_symbol>(_value);
+}
+
+inline lak::result<const lisk::resolved_symbol &>
+lisk::atom::get_resolved_symbol() const &
+{
+	return lak::get<lisk::resolved_symbol>(_value);
+}
+
+inline lak::result<lisk::resolved_symbol> lisk::atom::get_resolved_symbol() &&
+{
+	return lak::get<lisk::resolved_symbol>(lak::move(_value));
+}
+
 inline lak::result<lisk::string &> lisk::atom::get_string() &
 {
-	return lak::get<lisk::string>(_value);
+	return lak::get<lisk::box<lisk::string>>(_value).and_then(
+	  [](lisk::box<lisk::string> &b)
+	  { return lak::result_from_pointer(b.get()); });
 }
 
 inline lak::result<const lisk::string &> lisk::atom::get_string() const &
 {
-	return lak::get<lisk::string>(_value);
+	return lak::get<lisk::box<lisk::string>>(_value).and_then(
+	  [](const lisk::box<lisk::string> &b)
+	  { return lak::result_from_pointer(b.get()); });
 }
 
 inline lak::result<lisk::string> lisk::atom::get_string() &&
 {
-	return lak::get<lisk::string>(lak::move(_value));
+	return lak::get<lisk::box<lisk::string>>(_value).and_then(
+	  [](lisk::box<lisk::string> &b) -> lak::result<lisk::string>
+	  { return lak::ok_t<lisk::string>{b.take()}; });
 }
 
 inline lak::result<lisk::number &> lisk::atom::get_number() &
@@ -155,15 +214,21 @@ inline lak::result<bool> lisk::atom::get_bool() &&
 
 inline lak::result<lisk::pointer &> lisk::atom::get_pointer() &
 {
-	return lak::get<lisk::pointer>(_value);
+	return lak::get<lisk::box<lisk::pointer>>(_value).and_then(
+	  [](lisk::box<lisk::pointer> &b)
+	  { return lak::result_from_pointer(b.get()); });
 }
 
 inline lak::result<const lisk::pointer &> lisk::atom::get_pointer() const &
 {
-	return lak::get<lisk::pointer>(_value);
+	return lak::get<lisk::box<lisk::pointer>>(_value).and_then(
+	  [](const lisk::box<lisk::pointer> &b)
+	  { return lak::result_from_pointer(b.get()); });
 }
 
 inline lak::result<lisk::pointer> lisk::atom::get_pointer() &&
 {
-	return lak::get<lisk::pointer>(lak::move(_value));
+	return lak::get<lisk::box<lisk::pointer>>(_value).and_then(
+	  [](lisk::box<lisk::pointer> &b) -> lak::result<lisk::pointer>
+	  { return lak::ok_t<lisk::pointer>{b.take()}; });
 }
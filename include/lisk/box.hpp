@@ -0,0 +1,100 @@
+#ifndef LISK_BOX_HPP
+#define LISK_BOX_HPP
+
+#include "lisk/allocator.hpp"
+
+namespace lisk
+{
+	// Pointer to a T allocated from the node allocator. The T is shared
+	// between copies and only copied when a shared box is written to, so a
+	// box behaves like the T it holds while copying one costs a reference
+	// count increment. It keeps large and rarely used values out of line so
+	// they don't bloat every lisk::atom and lisk::expression. A default
+	// constructed or moved from box has no T, it reads as a default
+	// constructed T and allocates one when it's first written to.
+	//
+	// A reference returned by the non-const accessors is only good until the
+	// box is next copied, after that writes through it would be seen by the
+	// copy too.
+	template<typename T>
+	struct box
+	{
+		lisk::node_ptr<T> _ptr;
+
+		static const T &empty()
+		{
+			static const T value{};
+			return value;
+		}
+
+		box() = default;
+		box(const T &value) : _ptr(lisk::node_ptr<T>::make(value)) {}
+		box(T &&value) : _ptr(lisk::node_ptr<T>::make(lak::move(value))) {}
+
+		box(const box &other)       = default;
+		box(box &&other)            = default;
+		box &operator=(const box &other) = default;
+		box &operator=(box &&other)      = default;
+
+		// For writing to the T, copies it first if it's shared. Reads should go
+		// through the const overload, which never copies.
+		T *get()
+		{
+			if (!_ptr)
+				_ptr = lisk::node_ptr<T>::make();
+			else if (!_ptr.unique())
+				_ptr = lisk::node_ptr<T>::make(*_ptr);
+			return _ptr.get();
+		}
+		const T *get() const { return _ptr ? _ptr.get() : &empty(); }
+
+		T &operator*() { return *get(); }
+		const T &operator*() const { return *get(); }
+
+		T *operator->() { return get(); }
+		const T *operator->() const { return get(); }
+
+		// The T, moved out if this is the only reference to it and copied
+		// otherwise.
+		T take()
+		{
+			if (_ptr.unique()) return lak::move(*_ptr);
+			return *static_cast<const box &>(*this).get();
+		}
+	};
+
+	// Look through a box, used when visiting variants that hold boxed values.
+	template<typename T>
+	T &unbox(T &value)
+	{
+		return value;
+	}
+
+	template<typename T>
+	T &unbox(lisk::box<T> &value)
+	{
+		return *value;
+	}
+
+	template<typename T>
+	const T &unbox(const lisk::box<T> &value)
+	{
+		return *value;
+	}
+
+	// Like unbox, but boxed values are only ever read. The non-const visit
+	// overloads use this, so that reading a shared box doesn't copy it.
+	template<typename T>
+	T &visit_unbox(T &value)
+	{
+		return value;
+	}
+
+	template<typename T>
+	const T &visit_unbox(lisk::box<T> &value)
+	{
+		return *static_cast<const lisk::box<T> &>(value);
+	}
+}
+
+#endif
@@ -0,0 +1,127 @@
+#ifndef LISK_BYTECODE_HPP
+#define LISK_BYTECODE_HPP
+
+#include "lisk/environment.hpp"
+#include "lisk/expression.hpp"
+
+#include <lak/array.hpp>
+
+#include <cstdint>
+
+namespace lisk
+{
+	namespace bytecode
+	{
+		enum struct opcode : uint8_t
+		{
+			// push constants[a]
+			push_const,
+			// push env[constants[a]], constants[a] is a (resolved) symbol atom
+			load,
+			// pop
+			pop,
+			// pop value, define constants[a] as value, push nil
+			define,
+			// pc = a
+			jump,
+			// pop value as bool, if false pc = a. If value isn't a bool push a
+			// type error for argument 0 of constants[b] and pc = c.
+			branch,
+			// pop value, if it isn't nil pc = a, otherwise push nil
+			loop_while,
+			// pop value as a uint_t repeat count and push it. If value isn't a
+			// uint_t push a type error for argument 0 of constants[b] and pc = c.
+			repeat_init,
+			// if the count on top of the stack is 0 replace it with nil and
+			// pc = a, otherwise decrement it
+			repeat_step,
+			// check that the top of the stack is a number. If it isn't, pop b + 1
+			// values, push a type error for argument b of constants[a] and pc = c.
+			expect_number,
+			// pop 2 numbers and push the result
+			add,
+			sub,
+			mul,
+			div,
+			// pop a number and push whether it is zero
+			zero_check,
+			// pop a values and push them as a list
+			make_list,
+			// push a lambda built from the (params body) list constants[a]
+			make_lambda,
+			// push lisk::eval(constants[a])
+			eval,
+			// constants[a] is a call form whose head is a symbol taking c
+			// arguments. If the head is bound to a lambda that takes c parameters,
+			// push the lambda and continue so the arguments get evaluated before
+			// an apply. Otherwise call it like lisk::eval would, push the result
+			// and pc = b.
+			call,
+			// pop c arguments and a lambda, call the lambda in a new frame
+			apply,
+			// same as apply but replaces the current frame
+			tail_apply,
+			// return the top of the stack from the current frame
+			ret,
+		};
+
+		struct instruction
+		{
+			lisk::bytecode::opcode op;
+			uint32_t a = 0;
+			uint32_t b = 0;
+			uint32_t c = 0;
+		};
+
+		struct chunk
+		{
+			lak::vector<lisk::bytecode::instruction> code;
+			lak::vector<lisk::expression> constants;
+		};
+
+		// Compile exp to run in environments like env. The special forms (if,
+		// define, begin, lambda, tail, while, repeat, list, + - * / and zero?)
+		// are compiled inline when their symbol is bound to the builtin functor
+		// in env at compile time, so rebinding one of those symbols after an
+		// expression has been compiled won't be seen by it. Everything else
+		// is looked up and called at run time, with lisk::eval as the fallback
+		// for forms the compiler doesn't understand.
+		lisk::bytecode::chunk compile(const lisk::expression &exp,
+		                              const lisk::environment &env);
+
+		// The default limit on the memory used by the VM's value stack and call
+		// frames.
+		inline constexpr size_t default_memory_budget = size_t(64) << 20;
+
+		// Lambda calls made by the VM are kept on a heap allocated frame stack
+		// rather than the native stack, so recursion depth is only limited by
+		// memory_budget. Running out of budget returns an exception. A call to
+		// a lambda in tail position of a lambda body replaces the caller's
+		// frame, with or without an explicit tail, like lisk::lambda::apply.
+		//
+		// That only holds for calls the VM makes itself. The arguments of
+		// builtins that aren't compiled inline, and forms that fall back to
+		// lisk::eval, are evaluated by lisk::eval on the native stack, so
+		// recursion through them, as in (+ 1 (car (list (f (- n 1))))), is
+		// limited by lisk::set_eval_stack_budget like it is outside the VM.
+		// The VM can't evaluate those arguments itself, a functor may take
+		// them unevaluated.
+		lisk::expression run(
+		  const lisk::bytecode::chunk &c,
+		  lisk::environment &env,
+		  bool allow_tail_eval,
+		  size_t memory_budget = lisk::bytecode::default_memory_budget);
+
+		// Same semantics as lisk::eval, except that tail calls to lambdas
+		// are evaluated in place rather than returned as eval lists.
+		lisk::expression eval(
+		  const lisk::expression &exp,
+		  lisk::environment &env,
+		  bool allow_tail_eval,
+		  size_t memory_budget = lisk::bytecode::default_memory_budget);
+
+		lisk::string to_string(const lisk::bytecode::chunk &c);
+	}
+}
+
+#endif
@@ -1,6 +1,8 @@
 #ifndef LISK_CALLABLE_HPP
 #	define LISK_CALLABLE_HPP
 
+#	include "lisk/allocator.hpp"
+
 #	define LISK_ATOM_FORWARD_ONLY
 #	include "lisk/atom.hpp"
 
@@ -9,7 +11,6 @@
 
 #	include "lisk/functor.hpp"
 
-#	include <lak/memory.hpp>
 #	include <lak/tuple.hpp>
 #	include <lak/variant.hpp>
 
@@ -21,7 +22,7 @@ namespace lisk
 
 	struct callable
 	{
-		using lambda_ptr = lak::shared_ptr<lisk::lambda>;
+		using lambda_ptr = lisk::node_ptr<lisk::lambda>;
 		using value_type = lak::variant<lambda_ptr, lisk::functor>;
 		value_type _value;
 
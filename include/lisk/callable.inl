@@ -1,5 +1,6 @@
 #include "callable.hpp"
 
+#include "lisk/collector.hpp"
 #include "lisk/lambda.hpp"
 #include "lisk/shared_list.hpp"
 
@@ -9,6 +10,7 @@ inline lisk::callable::callable(const lisk::lambda &l)
 : _value(lak::in_place_index<decltype(_value)::index_of<lambda_ptr>>,
          lambda_ptr::make(l))
 {
+	lisk::impl::track_lambda(lak::get<lambda_ptr>(_value).unwrap());
 }
 
 inline lisk::callable::callable(const lisk::functor &f)
@@ -22,6 +24,7 @@ lisk::callable &lisk::callable::operator=(const lisk::lambda &l)
 {
 	_value.template emplace<decltype(_value)::index_of<lambda_ptr>>(
 	  lambda_ptr::make(l));
+	lisk::impl::track_lambda(lak::get<lambda_ptr>(_value).unwrap());
 	return *this;
 }
 
@@ -39,7 +42,7 @@ inline bool lisk::callable::is_null() const
 inline bool lisk::callable::is_lambda() const
 {
 	return lak::get<lambda_ptr>(_value).map_or(
-	  [](const auto &l) -> bool { return l; }, false);
+	  [](const auto &l) -> bool { return bool(l); }, false);
 }
 
 inline bool lisk::callable::is_functor() const
@@ -0,0 +1,58 @@
+#ifndef LISK_COLLECTOR_HPP
+#define LISK_COLLECTOR_HPP
+
+#include "lisk/allocator.hpp"
+
+#include <cstdint>
+
+namespace lisk
+{
+	struct lambda;
+
+	struct collector_stats
+	{
+		size_t collections = 0;
+		// Lambdas that are currently alive.
+		size_t tracked_lambdas = 0;
+		// Lambdas, list nodes, environment frames, vector and hash map nodes
+		// visited by the last collection.
+		size_t objects_scanned = 0;
+		// Lambdas found to only be kept alive by cycles.
+		size_t lambdas_freed      = 0;
+		size_t last_lambdas_freed = 0;
+		// The bytes_in_use of every live node allocator (each thread's node
+		// pool and each arena) summed, around the last collection.
+		int64_t heap_bytes_before = 0;
+		int64_t heap_bytes_after  = 0;
+		double last_collection_ms  = 0.0;
+		double total_collection_ms = 0.0;
+	};
+
+	// A named recursive lambda holds its captured environment, which holds the
+	// lambda, so reference counting alone never frees it. This finds every
+	// lambda that is only reachable through such cycles (by trial deletion
+	// starting from all live lambdas) and clears its captured environment and
+	// body so the cycle gets freed.
+	// No other thread may be using lisk values while this runs.
+	lisk::collector_stats collect_cycles();
+
+	lisk::collector_stats cycle_collector_stats();
+
+	namespace impl
+	{
+		// Put l on the lambda list of the allocator it came from, or of this
+		// thread if it came from the node pool.
+		void track_lambda(const lisk::node_ptr<lisk::lambda> &l);
+
+		void register_allocator(lisk::node_allocator *alloc);
+		void unregister_allocator(lisk::node_allocator *alloc);
+
+		// Clear the captured environment and body of every lambda allocated
+		// from alloc, which breaks any cycles they're part of. Used when the
+		// nodes from alloc are about to be freed. Only alloc's own lambda list
+		// is locked.
+		void release_lambdas(lisk::node_allocator &alloc);
+	}
+}
+
+#endif
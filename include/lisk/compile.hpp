@@ -0,0 +1,53 @@
+#ifndef LISK_COMPILE_HPP
+#define LISK_COMPILE_HPP
+
+#include "lisk/environment.hpp"
+#include "lisk/expression.hpp"
+#include "lisk/functor.hpp"
+
+#include <functional>
+
+namespace lisk
+{
+	// An expression that has been analysed once into a tree of C++ closures,
+	// so evaluating it again doesn't re-dispatch on the shape of the
+	// expression.
+	struct compiled_expression
+	{
+		using function_type = lisk::impl::compiled_function;
+
+		function_type _function;
+
+		compiled_expression()                            = default;
+		compiled_expression(const compiled_expression &) = default;
+		compiled_expression(compiled_expression &&)      = default;
+
+		compiled_expression &operator=(const compiled_expression &) = default;
+		compiled_expression &operator=(compiled_expression &&) = default;
+
+		inline explicit operator bool() const { return bool(_function); }
+
+		lisk::expression operator()(lisk::environment &env,
+		                            bool allow_tail_eval = true) const;
+	};
+
+	// Compile exp against env. Symbols defined in the innermost frame of env
+	// are bound to their definitions directly, and the builtin if, define,
+	// begin, lambda, while, repeat, list, + - * / and zero? forms are turned
+	// into specialised closures. Because of this the result must be run in env
+	// (or a copy of it), and rebinding one of those special forms after
+	// compiling won't be seen by the compiled expression. Anything else is
+	// looked up and called at run time like lisk::eval would.
+	//
+	// Calls to a LISK_FUNCTOR_WRAPPER functor have their arguments bound ahead
+	// of time: arguments that convert as they're written are converted once,
+	// the others are compiled, and the wrapped function is called with them
+	// directly. The head is still looked up on every call, if it no longer
+	// names the same functor the call goes through lisk::impl::eval_call.
+	// Other functors are always called through lisk::impl::eval_call with the
+	// unevaluated arguments.
+	lisk::compiled_expression compile(const lisk::expression &exp,
+	                                  const lisk::environment &env);
+}
+
+#endif
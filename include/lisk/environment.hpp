@@ -7,6 +7,9 @@
 #define LISK_SHARED_LIST_FORWARD_ONLY
 #include "lisk/shared_list.hpp"
 
+#include <lak/array.hpp>
+#include <lak/result.hpp>
+
 #include <unordered_map>
 
 namespace lisk
@@ -15,27 +18,90 @@ namespace lisk
 
 	struct environment
 	{
-		using value_type = lisk::basic_shared_list<
-		  std::unordered_map<lisk::symbol, lisk::expression>>;
-		value_type _map = {};
+		struct frame
+		{
+			// Lambda call frames bind their parameters to flat slots so that
+			// resolved symbols can address them directly, anything else that is
+			// defined in the frame goes into the map.
+			lak::vector<lak::pair<lisk::symbol, lisk::expression>> slots;
+			std::unordered_map<lisk::symbol, lisk::expression> map;
+			// Loop frames only bind their slots, anything else that's defined
+			// while they're innermost goes into the enclosing frame.
+			bool loop = false;
+			// Frozen frames are never modified again, so they can be read from
+			// any number of threads at once.
+			bool frozen = false;
+
+			bool empty() const;
+
+			// Whether any value bound in the frame holds nodes of its own (see
+			// lisk::expression::owns_nodes).
+			bool owns_nodes() const;
+
+			lisk::expression *find(const lisk::symbol &sym);
+			const lisk::expression *find(const lisk::symbol &sym) const;
+
+			lisk::expression &operator[](const lisk::symbol &sym);
+
+			// Moves everything from other that isn't already defined in this
+			// frame into the map.
+			void merge(frame &other);
+		};
+
+		using value_type = lisk::basic_shared_list<frame>;
+		value_type _map  = {};
 
-		environment()                    = default;
-		environment(const environment &) = default;
-		environment(environment &&)      = default;
+		environment() = default;
+		// Copies of a frozen environment get a writable frame of their own
+		// straight away, see freeze.
+		environment(const environment &other);
+		environment(environment &&) = default;
 
-		environment &operator=(const environment &) = default;
+		environment &operator=(const environment &other);
 		environment &operator=(environment &&) = default;
 
 		static environment extends(const environment &other);
 
+		// A loop frame on top of other with a single slot for sym.
+		static environment extends_loop(const environment &other,
+		                                const lisk::symbol &sym);
+
+		// The frame that a definition of sym is made in. If this environment
+		// is empty or that would be a frozen frame, a new frame is pushed in
+		// front first.
+		frame &defining_frame(const lisk::symbol &sym);
+
+		// Freeze every frame in this environment. Copies of a frozen
+		// environment, and environments that extend it, can then be used from
+		// different threads at once. A copy pushes a frame of its own in front
+		// of the frozen ones as it's made, so that everything evaluated against
+		// it, lambdas included, sees the definitions made through it. The
+		// frozen environment itself must only be copied or extended, never
+		// defined into.
+		environment &freeze();
+
 		void define_expr(const lisk::symbol &sym, const lisk::expression &expr);
 		void define_atom(const lisk::symbol &sym, const lisk::atom &a);
 		void define_list(const lisk::symbol &sym, const lisk::shared_list &list);
 		void define_callable(const lisk::symbol &sym, const lisk::callable &c);
 		void define_functor(const lisk::symbol &sym, const lisk::functor &f);
 
+		// Appends a new slot to the innermost frame, this must only be used
+		// while binding a frame before any symbols are resolved against it.
+		void define_slot(const lisk::symbol &sym, const lisk::expression &expr);
+
 		lisk::expression operator[](const lisk::symbol &sym) const;
+		lisk::expression operator[](const lisk::resolved_symbol &sym) const;
+
+		// Like operator[] but returns nullptr instead of an exception if sym
+		// isn't defined.
+		const lisk::expression *find(const lisk::symbol &sym) const;
+
+		// Find the slot that sym currently refers to. Fails if sym isn't bound
+		// or is bound by a frame's map rather than a slot.
+		lak::result<lisk::resolved_symbol> resolve(const lisk::symbol &sym) const;
 
+		// The copied frames aren't frozen.
 		environment clone(size_t depth = 0) const;
 		environment &squash(size_t depth);
 	};
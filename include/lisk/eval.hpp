@@ -18,6 +18,8 @@
 
 #	include <lak/tuple.hpp>
 
+#	include <cstdint>
+
 namespace lisk
 {
 	struct lambda;
@@ -30,8 +32,72 @@ namespace lisk
 	                      lisk::environment &e,
 	                      bool allow_tail_eval);
 
+	// The native stack in bytes that nested evaluation on this thread may use,
+	// measured from the outermost lisk::eval call, before it returns an
+	// exception instead of recursing any further. Defaults to 6MiB (768KiB on
+	// Windows), threads with smaller stacks should lower it. The threads of a
+	// lisk::worker_pool lower it to fit their stack themselves.
+	size_t eval_stack_budget();
+	void set_eval_stack_budget(size_t bytes);
+
+	// The evaluation steps this thread has left. Every lisk::eval, loop
+	// iteration and tail call takes a step. Once they run out the step
+	// handler is called, and if that doesn't grant any more steps the step
+	// returns an exception, as does every step after it, so the evaluation
+	// unwinds without doing any further work. Defaults to SIZE_MAX.
+	size_t eval_step_budget();
+	void set_eval_step_budget(size_t steps);
+
+	// Called when the evaluation runs out of steps, in the middle of it.
+	// Returns the number of steps to continue with, or 0 to stop. A scheduler
+	// can use this to check a deadline or a cancellation flag, or to block the
+	// thread until the script's next time slice. The parallel builtins call
+	// the handler of the thread that started them from whichever of the
+	// pool's threads ran out, one call at a time.
+	using eval_step_handler = size_t (*)(void *context);
+
+	// nullptr (the default) stops as soon as the steps run out. Returns the
+	// previous handler and context.
+	lak::pair<lisk::eval_step_handler, void *> set_eval_step_handler(
+	  lisk::eval_step_handler handler, void *context = nullptr);
+	lak::pair<lisk::eval_step_handler, void *> get_eval_step_handler();
+
 	namespace impl
 	{
+		// Measures the native stack used since the outermost live stack_guard
+		// on this thread.
+		struct stack_guard
+		{
+			uintptr_t _here;
+			bool _outermost;
+
+			stack_guard();
+			~stack_guard();
+
+			stack_guard(const stack_guard &) = delete;
+			stack_guard &operator=(const stack_guard &) = delete;
+
+			bool exceeded() const;
+			lisk::exception error() const;
+		};
+
+		// Take an evaluation step, returns false if there are none left.
+		bool take_step();
+		lisk::exception steps_exceeded();
+
+		// Finish evaluating the call form l, after its head has been evaluated
+		// to subexp.
+		lisk::expression eval_call(const lisk::shared_list &l,
+		                           const lisk::expression &subexp,
+		                           lisk::environment &e,
+		                           bool allow_tail_eval);
+
+		// The error reported when argument index of a call, the first element of
+		// arg, couldn't be converted to type_name.
+		lisk::exception argument_error(const lisk::shared_list &arg,
+		                               size_t index,
+		                               const lisk::string &type_name);
+
 		template<typename... TYPES>
 		bool get_or_eval_arg_as(lisk::shared_list in_list,
 		                        lisk::environment &e,
@@ -109,6 +175,70 @@ namespace lisk
 		template<typename T>
 		bool operator>>(T &out);
 	};
+
+	namespace impl
+	{
+		template<typename T>
+		inline constexpr lisk::impl::argument_kind argument_kind_of =
+		  !lisk::list_reader_traits<T>::allow_eval
+		    ? lisk::impl::argument_kind::unevaluated
+		  : lisk::list_reader_traits<T>::allow_get
+		    ? lisk::impl::argument_kind::converted_or_evaluated
+		    : lisk::impl::argument_kind::evaluated;
+
+		// An argument of a compiled call to a LISK_FUNCTOR_WRAPPER functor.
+		template<typename T>
+		struct bound_argument
+		{
+			// The rest of the call's arguments, starting at this one.
+			lisk::shared_list arg;
+			size_t index = 0;
+			// Set when the argument converts to a T as it's written, which it then
+			// does on every call.
+			bool is_constant = false;
+			T constant{};
+			lisk::impl::compiled_function evaluate;
+
+			bool get(lisk::environment &e,
+			         bool allow_tail,
+			         lisk::exception &exc,
+			         T &out) const;
+		};
+
+		template<typename TUPLE>
+		struct compiled_call;
+
+		template<typename... ARGS>
+		struct compiled_call<lak::tuple<ARGS...>>
+		{
+			static constexpr lisk::impl::argument_kind arguments[sizeof...(ARGS) + 1] =
+			  {lisk::impl::argument_kind_of<lak::remove_cv_t<ARGS>>...,
+			   lisk::impl::argument_kind::unevaluated};
+
+			template<auto F>
+			static lisk::impl::compiled_function bind(
+			  const lisk::shared_list &args,
+			  lak::vector<lisk::impl::compiled_function> &evaluated);
+		};
+
+		template<auto F>
+		struct functor_wrapper
+		{
+			using arguments_t = lisk::as_functor_arguments_t<
+			  lisk::function_arguments_t<decltype(F)>>;
+
+			static lak::pair<lisk::expression, size_t> call(lisk::shared_list l,
+			                                                lisk::environment &e,
+			                                                bool allow_tail);
+
+			static lisk::impl::compiled_function bind(
+			  const lisk::shared_list &args,
+			  lak::vector<lisk::impl::compiled_function> &evaluated);
+
+			// Registers the signature the first time it's called.
+			static lisk::functor functor();
+		};
+	}
 }
 
 #	define LISK_EVAL_HPP_FINISHED
@@ -65,10 +65,7 @@ bool lisk::impl::get_or_eval_arg_as<TYPES...>(lisk::shared_list in_list,
 		{
 			if (!(reader >> element))
 			{
-				exc.message = "Failed to evaluate element " + std::to_string(i) +
-				              " '" + to_string(reader.list.value()) + "' of '" +
-				              to_string(reader.list) + "', expected type '" +
-				              type_name(element) + "'";
+				exc = lisk::impl::argument_error(reader.list, i, type_name(element));
 				return false;
 			}
 			return true;
@@ -92,3 +89,119 @@ bool lisk::impl::get_or_eval_arg_as<TYPES...>(lisk::shared_list in_list,
 		                           out_arg,
 		                           lak::index_sequence_for<TYPES...>{});
 }
+
+template<typename T>
+bool lisk::impl::bound_argument<T>::get(lisk::environment &e,
+                                        bool allow_tail,
+                                        lisk::exception &exc,
+                                        T &out) const
+{
+	if (is_constant)
+	{
+		out = constant;
+		return true;
+	}
+	if (evaluate && evaluate(e, allow_tail) >> out) return true;
+	exc = lisk::impl::argument_error(arg, index, type_name(out));
+	return false;
+}
+
+template<typename... ARGS>
+template<auto F>
+lisk::impl::compiled_function
+lisk::impl::compiled_call<lak::tuple<ARGS...>>::bind(
+  [[maybe_unused]] const lisk::shared_list &args,
+  [[maybe_unused]] lak::vector<lisk::impl::compiled_function> &evaluated)
+{
+	auto _bind = [&]<size_t... I>(lak::index_sequence<I...>)
+	  -> lisk::impl::compiled_function
+	{
+		lak::tuple<lisk::impl::bound_argument<lak::remove_cv_t<ARGS>>...> bound;
+
+		[[maybe_unused]] auto _bind_arg = [&](auto &b, size_t i)
+		{
+			using type = std::remove_cvref_t<decltype(b.constant)>;
+			b.arg      = args.next(i);
+			b.index    = i;
+			// Mirrors list_reader, which tries the conversion first.
+			if constexpr (lisk::list_reader_traits<type>::allow_get)
+				b.is_constant = bool(b.arg.value() >> b.constant);
+			if constexpr (lisk::list_reader_traits<type>::allow_eval)
+				if (!b.is_constant) b.evaluate = lak::move(evaluated[i]);
+		};
+		(_bind_arg(bound.template get<I>(), I), ...);
+
+		return [=](lisk::environment &e, bool allow_tail) -> lisk::expression
+		{
+			lak::tuple<lak::remove_cv_t<ARGS>...> values;
+			lisk::exception exc;
+			if (!(bound.template get<I>().get(
+			        e, allow_tail, exc, values.template get<I>()) &&
+			      ...))
+				return exc;
+			return lak::apply(
+			  F, lak::tuple_cat(lak::forward_as_tuple(e, allow_tail), values));
+		};
+	};
+
+	return _bind(lak::index_sequence_for<ARGS...>{});
+}
+
+template<auto F>
+lak::pair<lisk::expression, size_t> lisk::impl::functor_wrapper<F>::call(
+  lisk::shared_list l, lisk::environment &e, bool allow_tail)
+{
+	static_assert(
+	  lak::is_same_v<lak::tuple_element_t<0, lisk::function_arguments_t<decltype(F)>>,
+	                 lisk::environment &>);
+
+	static_assert(
+	  lak::is_same_v<lak::tuple_element_t<1, lisk::function_arguments_t<decltype(F)>>,
+	                 bool>);
+
+	static_assert(
+	  lak::is_same_v<lisk::function_return_t<decltype(F)>, lisk::expression>);
+
+	static_assert(lak::is_tuple_v<arguments_t>);
+
+	arguments_t args;
+	lisk::exception exc;
+
+	if (!lisk::impl::get_or_eval_arg_as(l, e, allow_tail, exc, args))
+	{
+		return lak::pair<lisk::expression, size_t>(exc, 0);
+	}
+	else
+	{
+		lisk::expression exp{
+		  lak::apply(F, lak::tuple_cat(lak::forward_as_tuple(e, allow_tail), args))};
+
+		return lak::pair<lisk::expression, size_t>(
+		  lak::move(exp), lak::tuple_size_v<arguments_t>);
+	}
+}
+
+template<auto F>
+lisk::impl::compiled_function lisk::impl::functor_wrapper<F>::bind(
+  const lisk::shared_list &args,
+  lak::vector<lisk::impl::compiled_function> &evaluated)
+{
+	return lisk::impl::compiled_call<arguments_t>::template bind<F>(args,
+	                                                                evaluated);
+}
+
+template<auto F>
+lisk::functor lisk::impl::functor_wrapper<F>::functor()
+{
+	static const lisk::functor result = []
+	{
+		const lisk::functor f = &call;
+		lisk::impl::register_functor_signature(
+		  f,
+		  {lak::tuple_size_v<arguments_t>,
+		   lisk::impl::compiled_call<arguments_t>::arguments,
+		   &bind});
+		return f;
+	}();
+	return result;
+}
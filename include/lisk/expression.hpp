@@ -12,6 +12,7 @@ namespace lisk
 #	define LISK_SHARED_LIST_FORWARD_ONLY
 #	include "lisk/shared_list.hpp"
 
+#	include "lisk/box.hpp"
 #	include "lisk/string.hpp"
 
 namespace lisk
@@ -39,6 +40,12 @@ namespace lisk
 #	define LISK_ATOM_FORWARD_ONLY
 #	include "lisk/atom.hpp"
 
+#	define LISK_VECTOR_FORWARD_ONLY
+#	include "lisk/vector.hpp"
+
+#	define LISK_HASH_MAP_FORWARD_ONLY
+#	include "lisk/hash_map.hpp"
+
 namespace lisk
 {
 	struct callable;
@@ -49,12 +56,18 @@ namespace lisk
 		{
 		};
 
+		// Exceptions are boxed so that an expression is 32 bytes, which keeps
+		// list nodes small. Getting down to 16 or 8 bytes would take packing
+		// atoms and numbers into a single tagged word, which the get_*
+		// functions can't hand out references into.
 		using value_type = lak::variant<null,
 		                                lisk::atom,
 		                                lisk::eval_shared_list,
 		                                lisk::shared_list,
 		                                lisk::callable,
-		                                lisk::exception>;
+		                                lisk::vector,
+		                                lisk::hash_map,
+		                                lisk::box<lisk::exception>>;
 
 		value_type _value;
 
@@ -71,6 +84,8 @@ namespace lisk
 		inline expression(const lisk::shared_list &list);
 		inline expression(const lisk::eval_shared_list &list);
 		inline expression(const lisk::callable &c);
+		inline expression(const lisk::vector &v);
+		inline expression(const lisk::hash_map &m);
 		inline expression(const lisk::exception &exc);
 
 		inline expression &operator=(null);
@@ -79,6 +94,8 @@ namespace lisk
 		inline expression &operator=(const lisk::shared_list &list);
 		inline expression &operator=(const lisk::eval_shared_list &list);
 		inline expression &operator=(const lisk::callable &c);
+		inline expression &operator=(const lisk::vector &v);
+		inline expression &operator=(const lisk::hash_map &m);
 		inline expression &operator=(const lisk::exception &exc);
 
 		inline bool is_null() const;
@@ -86,8 +103,14 @@ namespace lisk
 		inline bool is_list() const;
 		inline bool is_eval_list() const;
 		inline bool is_callable() const;
+		inline bool is_vector() const;
+		inline bool is_hash_map() const;
 		inline bool is_exception() const;
 
+		// Whether this holds list nodes, a lambda or the nodes of a vector or
+		// hash map, which containers release through the release queue.
+		inline bool owns_nodes() const;
+
 		inline bool empty() const { return is_null() || is_exception(); }
 		inline operator bool() const { return !empty(); }
 
@@ -107,6 +130,14 @@ namespace lisk
 		inline lak::result<const lisk::callable &> get_callable() const &;
 		inline lak::result<lisk::callable> get_callable() &&;
 
+		inline lak::result<lisk::vector &> get_vector() &;
+		inline lak::result<const lisk::vector &> get_vector() const &;
+		inline lak::result<lisk::vector> get_vector() &&;
+
+		inline lak::result<lisk::hash_map &> get_hash_map() &;
+		inline lak::result<const lisk::hash_map &> get_hash_map() const &;
+		inline lak::result<lisk::hash_map> get_hash_map() &&;
+
 		inline lak::result<lisk::exception &> get_exception() &;
 		inline lak::result<const lisk::exception &> get_exception() const &;
 		inline lak::result<lisk::exception> get_exception() &&;
@@ -114,13 +145,17 @@ namespace lisk
 		template<typename LAMBDA>
 		auto visit(LAMBDA &&lambda) const
 		{
-			return lak::visit(lambda, _value);
+			return lak::visit([&](auto &v) { return lambda(lisk::unbox(v)); },
+			                  _value);
 		}
 
+		// Boxed values are visited as const, write to them through the get_
+		// accessors.
 		template<typename LAMBDA>
 		auto visit(LAMBDA &&lambda)
 		{
-			return lak::visit(lambda, _value);
+			return lak::visit(
+			  [&](auto &v) { return lambda(lisk::visit_unbox(v)); }, _value);
 		}
 	};
 
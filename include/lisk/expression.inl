@@ -1,6 +1,8 @@
 #include "expression.hpp"
 
 #include "lisk/callable.hpp"
+#include "lisk/hash_map.hpp"
+#include "lisk/vector.hpp"
 
 /* --- constructor --- */
 
@@ -25,7 +27,15 @@ lisk::expression::expression(const lisk::eval_shared_list &list) : _value(list)
 
 lisk::expression::expression(const lisk::callable &c) : _value(c) {}
 
-lisk::expression::expression(const lisk::exception &exc) : _value(exc) {}
+lisk::expression::expression(const lisk::vector &v) : _value(v) {}
+
+lisk::expression::expression(const lisk::hash_map &m) : _value(m) {}
+
+lisk::expression::expression(const lisk::exception &exc)
+: _value(lak::in_place_index<value_type::index_of<lisk::box<lisk::exception>>>,
+         exc)
+{
+}
 
 /* --- operator= --- */
 
@@ -66,9 +76,21 @@ lisk::expression &lisk::expression::operator=(const lisk::callable &c)
 	return *this;
 }
 
+lisk::expression &lisk::expression::operator=(const lisk::vector &v)
+{
+	_value.emplace<decltype(_value)::index_of<vector>>(v);
+	return *this;
+}
+
+lisk::expression &lisk::expression::operator=(const lisk::hash_map &m)
+{
+	_value.emplace<decltype(_value)::index_of<hash_map>>(m);
+	return *this;
+}
+
 lisk::expression &lisk::expression::operator=(const lisk::exception &exc)
 {
-	_value.emplace<decltype(_value)::index_of<exception>>(exc);
+	_value.emplace<decltype(_value)::index_of<lisk::box<lisk::exception>>>(exc);
 	return *this;
 }
 
@@ -97,9 +119,25 @@ bool lisk::expression::is_callable() const
 	return _value.template holds<lisk::callable>();
 }
 
+bool lisk::expression::is_vector() const
+{
+	return _value.template holds<lisk::vector>();
+}
+
+bool lisk::expression::is_hash_map() const
+{
+	return _value.template holds<lisk::hash_map>();
+}
+
 bool lisk::expression::is_exception() const
 {
-	return _value.template holds<lisk::exception>();
+	return _value.template holds<lisk::box<lisk::exception>>();
+}
+
+bool lisk::expression::owns_nodes() const
+{
+	return is_list() || is_eval_list() || is_callable() || is_vector() ||
+	       is_hash_map();
 }
 
 inline lak::result<lisk::atom &> lisk::expression::get_atom() &
@@ -166,20 +204,57 @@ inline lak::result<lisk::callable> lisk::expression::get_callable() &&
 	return lak::get<lisk::callable>(lak::move(_value));
 }
 
+inline lak::result<lisk::vector &> lisk::expression::get_vector() &
+{
+	return lak::get<lisk::vector>(_value);
+}
+
+inline lak::result<const lisk::vector &> lisk::expression::get_vector() const &
+{
+	return lak::get<lisk::vector>(_value);
+}
+
+inline lak::result<lisk::vector> lisk::expression::get_vector() &&
+{
+	return lak::get<lisk::vector>(lak::move(_value));
+}
+
+inline lak::result<lisk::hash_map &> lisk::expression::get_hash_map() &
+{
+	return lak::get<lisk::hash_map>(_value);
+}
+
+inline lak::result<const lisk::hash_map &> lisk::expression::get_hash_map()
+  const &
+{
+	return lak::get<lisk::hash_map>(_value);
+}
+
+inline lak::result<lisk::hash_map> lisk::expression::get_hash_map() &&
+{
+	return lak::get<lisk::hash_map>(lak::move(_value));
+}
+
 inline lak::result<lisk::exception &> lisk::expression::get_exception() &
 {
-	return lak::get<lisk::exception>(_value);
+	return lak::get<lisk::box<lisk::exception>>(_value).and_then(
+	  [](lisk::box<lisk::exception> &b)
+	  { return lak::result_from_pointer(b.get()); });
 }
 
 inline lak::result<const lisk::exception &> lisk::expression::get_exception()
   const &
 {
-	return lak::get<lisk::exception>(_value);
+	return lak::get<lisk::box<lisk::exception>>(_value).and_then(
+	  [](const lisk::box<lisk::exception> &b)
+	  { return lak::result_from_pointer(b.get()); });
 }
 
 inline lak::result<lisk::exception> lisk::expression::get_exception() &&
 {
-	return lak::get<lisk::exception>(lak::move(_value));
+	return lak::get<lisk::box<lisk::exception>>(_value).and_then(
+	  [](lisk::box<lisk::exception> &b) -> lak::result<lisk::exception>
+	  { return lak::ok_t<lisk::exception>{b.take()}; });
 }
 
 template<typename T>
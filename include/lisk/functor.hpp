@@ -4,10 +4,14 @@
 #define LISK_SHARED_LIST_FORWARD_ONLY
 #include "lisk/shared_list.hpp"
 
+#include <lak/array.hpp>
 #include <lak/tuple.hpp>
 #include <lak/type_traits.hpp>
 #include <lak/variant.hpp>
 
+#include <cstdint>
+#include <functional>
+
 namespace lisk
 {
 	struct expression;
@@ -52,45 +56,51 @@ namespace lisk
 	typedef lak::pair<lisk::expression, size_t> (*functor)(
 	  lisk::basic_shared_list<lisk::expression>, lisk::environment &, bool);
 
-#define LISK_FUNCTOR_WRAPPER(F)                                               \
-	static_cast<lisk::functor>(                                                 \
-	  [](lisk::shared_list l,                                                   \
-	     lisk::environment &e,                                                  \
-	     bool allow_tail) -> lak::pair<lisk::expression, size_t>                \
-	  {                                                                         \
-			static_assert(                                                          \
-			  lak::is_same_v<                                                       \
-			    lak::tuple_element_t<0, lisk::function_arguments_t<decltype(F)>>,   \
-			    lisk::environment &>);                                              \
-                                                                              \
-			static_assert(                                                          \
-			  lak::is_same_v<                                                       \
-			    lak::tuple_element_t<1, lisk::function_arguments_t<decltype(F)>>,   \
-			    bool>);                                                             \
-                                                                              \
-			static_assert(lak::is_same_v<lisk::function_return_t<decltype(F)>,      \
-			                             lisk::expression>);                        \
-                                                                              \
-			using arguments_t = lisk::as_functor_arguments_t<                       \
-			  lisk::function_arguments_t<decltype(F)>>;                             \
-			static_assert(lak::is_tuple_v<arguments_t>);                            \
-                                                                              \
-			arguments_t args;                                                       \
-			lisk::exception exc;                                                    \
-                                                                              \
-			if (!lisk::impl::get_or_eval_arg_as(l, e, allow_tail, exc, args))       \
-			{                                                                       \
-				return lak::pair<lisk::expression, size_t>(exc, 0);                   \
-			}                                                                       \
-			else                                                                    \
-			{                                                                       \
-				lisk::expression exp{lak::apply(                                      \
-				  F, lak::tuple_cat(lak::forward_as_tuple(e, allow_tail), args))};    \
-                                                                              \
-				return lak::pair<lisk::expression, size_t>(                           \
-				  lak::move(exp), lak::tuple_size_v<arguments_t>);                    \
-			}                                                                       \
-	  })
+	namespace impl
+	{
+		using compiled_function =
+		  std::function<lisk::expression(lisk::environment &, bool)>;
+
+		// How a functor argument is read (see lisk::list_reader_traits).
+		enum struct argument_kind : uint8_t
+		{
+			// Converted as it's written if it can be, otherwise evaluated.
+			converted_or_evaluated,
+			evaluated,
+			// Converted as it's written, never evaluated.
+			unevaluated,
+		};
+
+		// The arguments of a LISK_FUNCTOR_WRAPPER functor, which lets lisk::compile
+		// convert them ahead of time and call the wrapped function directly.
+		struct functor_signature
+		{
+			size_t arity;
+			const lisk::impl::argument_kind *arguments;
+			// Bind the first arity elements of args, a call's unevaluated
+			// arguments. evaluated holds the compiled form of each argument that
+			// isn't unevaluated, and is moved from. Returns the closure that
+			// converts the arguments and calls the wrapped function.
+			lisk::impl::compiled_function (*bind)(
+			  const lisk::basic_shared_list<lisk::expression> &args,
+			  lak::vector<lisk::impl::compiled_function> &evaluated);
+		};
+
+		void register_functor_signature(lisk::functor f,
+		                                const lisk::impl::functor_signature &sig);
+
+		// The signature of f if it was made by LISK_FUNCTOR_WRAPPER, or nullptr.
+		const lisk::impl::functor_signature *find_functor_signature(
+		  lisk::functor f);
+
+		template<auto F>
+		struct functor_wrapper;
+	}
+
+	// The functor that converts its arguments to the parameters of F after the
+	// environment and allow_tail, and calls F with them. The same F always
+	// gives the same functor.
+#define LISK_FUNCTOR_WRAPPER(F) lisk::impl::functor_wrapper<F>::functor()
 
 	lisk::string to_string(lisk::functor f);
 	const lisk::string &type_name(const lisk::functor &);
@@ -0,0 +1,78 @@
+#ifndef LISK_HASH_MAP_HPP
+#	define LISK_HASH_MAP_HPP
+
+#	include "lisk/allocator.hpp"
+#	include "lisk/string.hpp"
+
+#	include <lak/result.hpp>
+
+namespace lisk
+{
+	struct atom;
+	struct expression;
+	struct hash_map_node;
+
+	// Map from atoms to expressions with structural sharing, stored as a hash
+	// array mapped trie (the compressed CHAMP layout: each node keeps its
+	// entries and its children in separate dense arrays indexed by bitmaps).
+	// Lookups walk at most one node per 5 bits of hash, and a modified copy
+	// shares everything but the path to the node that changed.
+	//
+	// Like lisk::vector, lisk code only sees hash maps as values and in C++
+	// a hash_map is a copy-on-write value.
+	//
+	// Keys are nil, bools, numbers, strings and symbols. Symbols and strings
+	// hash with their std::hash specialisations. Numbers only match numbers
+	// of the same type, so 1 and +1 are different keys.
+	struct hash_map
+	{
+		static constexpr size_t bits  = 5;
+		static constexpr size_t width = size_t(1) << bits;
+
+		lisk::node_ptr<lisk::hash_map_node> _root;
+		size_t _size = 0;
+
+		hash_map()                  = default;
+		hash_map(const hash_map &m) = default;
+		hash_map(hash_map &&m)      = default;
+
+		hash_map &operator=(const hash_map &m) = default;
+		hash_map &operator=(hash_map &&m) = default;
+
+		inline size_t size() const { return _size; }
+		inline bool empty() const { return _size == 0; }
+
+		// Fails for atoms that can't be used as keys.
+		static lak::result<size_t> hash(const lisk::atom &key);
+
+		lak::result<const lisk::expression &> find(const lisk::atom &key) const;
+
+		// Returns false if key can't be used as a key.
+		bool set(const lisk::atom &key, lisk::expression value);
+
+		// Returns false if key wasn't in the map.
+		bool remove(const lisk::atom &key);
+
+		// Calls f(const lisk::atom &key, const lisk::expression &value) for
+		// every entry, in an unspecified order.
+		template<typename F>
+		void for_each(F &&f) const;
+	};
+
+	lisk::string to_string(const lisk::hash_map &m);
+	const lisk::string &type_name(const lisk::hash_map &);
+}
+
+bool operator>>(const lisk::expression &arg, lisk::hash_map &out);
+
+#	define LISK_HASH_MAP_HPP_FINISHED
+#endif
+
+#ifdef LISK_HASH_MAP_FORWARD_ONLY
+#	undef LISK_HASH_MAP_FORWARD_ONLY
+#else
+#	if defined(LISK_HASH_MAP_HPP_FINISHED) && !defined(LISK_HASH_MAP_HPP_IMPL)
+#		define LISK_HASH_MAP_HPP_IMPL
+#		include "hash_map.inl"
+#	endif
+#endif
@@ -0,0 +1,52 @@
+#include "hash_map.hpp"
+
+#include "lisk/atom.hpp"
+#include "lisk/expression.hpp"
+
+#include <lak/array.hpp>
+
+namespace lisk
+{
+	struct hash_map_entry
+	{
+		lisk::atom key;
+		lisk::expression value;
+		size_t hash;
+	};
+
+	struct hash_map_node
+	{
+		// Bit i of datamap is set when the 5 bit hash chunk i at this level is
+		// held by one of entries, and bit i of nodemap when it's held by one of
+		// children. Both arrays are ordered by chunk. Nodes below the last
+		// chunk of the hash hold colliding entries in no particular order and
+		// have no bitmaps.
+		uint32_t datamap = 0;
+		uint32_t nodemap = 0;
+		lak::vector<lisk::hash_map_entry> entries;
+		lak::vector<lisk::node_ptr<lisk::hash_map_node>> children;
+
+		hash_map_node()                      = default;
+		hash_map_node(const hash_map_node &) = default;
+
+		// Hands values that own nodes to this thread's release queue, so
+		// dropping deeply nested maps doesn't recurse.
+		~hash_map_node();
+	};
+
+	namespace impl
+	{
+		template<typename F>
+		void for_each_entry(const lisk::hash_map_node &node, F &f)
+		{
+			for (const auto &entry : node.entries) f(entry.key, entry.value);
+			for (const auto &child : node.children) for_each_entry(*child, f);
+		}
+	}
+}
+
+template<typename F>
+void lisk::hash_map::for_each(F &&f) const
+{
+	if (_root) lisk::impl::for_each_entry(*_root, f);
+}
@@ -10,23 +10,48 @@
 #define LISK_SHARED_LIST_FORWARD_ONLY
 #include "lisk/shared_list.hpp"
 
+#include <lak/array.hpp>
+#include <lak/memory.hpp>
+
+#include <atomic>
+
 namespace lisk
 {
+	namespace bytecode
+	{
+		struct chunk;
+	}
+
 	struct lambda
 	{
-		lisk::shared_list params;
+		lak::vector<lisk::symbol> params;
 		lisk::shared_list exp;
 		lisk::environment captured_env;
 
-		lambda()               = default;
-		lambda(const lambda &) = default;
-		lambda &operator=(const lambda &) = default;
+		// exp compiled by lisk::bytecode the first time the lambda is applied
+		// by the VM, shared with copies of this lambda made after that.
+		// compiled is written once, before compiled_code is set to it, so a
+		// thread that sees compiled_code set can read compiled without a lock.
+		mutable lak::shared_ptr<const lisk::bytecode::chunk> compiled;
+		mutable std::atomic<const lisk::bytecode::chunk *> compiled_code =
+		  nullptr;
+
+		lambda() = default;
+		lambda(const lambda &other);
+		lambda &operator=(const lambda &other);
 
 		lambda(lisk::shared_list l, lisk::environment &e, bool allow_tail_eval);
 
 		lak::pair<lisk::expression, size_t> operator()(lisk::shared_list l,
 		                                               lisk::environment &e,
 		                                               bool allow_tail_eval) const;
+
+		// Evaluate exp in call_env, a frame extending captured_env with params
+		// bound. Calls to lambdas in tail position of the body (through if,
+		// begin and tail) replace call_env instead of nesting another call, so
+		// tail recursion runs in constant stack and memory.
+		lisk::expression apply(lisk::environment call_env,
+		                       bool allow_tail_eval) const;
 	};
 
 	lisk::string to_string(const lisk::lambda &l);
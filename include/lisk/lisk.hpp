@@ -2,44 +2,116 @@
 #define LISK_HPP
 
 #include "lisk/atom.hpp"
+#include "lisk/box.hpp"
+#include "lisk/bytecode.hpp"
 #include "lisk/callable.hpp"
+#include "lisk/collector.hpp"
+#include "lisk/compile.hpp"
 #include "lisk/environment.hpp"
 #include "lisk/eval.hpp"
 #include "lisk/expression.hpp"
 #include "lisk/functor.hpp"
+#include "lisk/hash_map.hpp"
 #include "lisk/lambda.hpp"
 #include "lisk/number.hpp"
+#include "lisk/numeric_array.hpp"
 #include "lisk/pointer.hpp"
+#include "lisk/runtime.hpp"
 #include "lisk/shared_list.hpp"
+#include "lisk/vector.hpp"
+#include "lisk/worker_pool.hpp"
 
 #include <lak/array.hpp>
+#include <lak/result.hpp>
 #include <lak/memory.hpp>
 #include <lak/string.hpp>
 #include <lak/tuple.hpp>
 #include <lak/variant.hpp>
 
 #include <regex>
+#include <string_view>
 #include <unordered_map>
 
 namespace lisk
 {
+	// The numeric literal grammar, kept as the reference for scan_number.
 	extern const std::regex numeric_regex;
 
 	bool is_whitespace(const char c);
 	bool is_bracket(const char c);
-	bool is_numeric(const lisk::string &token);
+	bool is_numeric(std::string_view token);
+
+	// Classify and parse a numeric literal in a single pass. Accepts exactly the
+	// tokens matched by numeric_regex, errors for anything else (including
+	// integer literals that are out of range).
+	lak::result<lisk::number> scan_number(std::string_view token);
 
 	bool is_nil(const lisk::expression &expr);
 	bool is_null(const lisk::expression &expr);
 
+	enum struct token_kind : uint8_t
+	{
+		// One of ()[]{}.
+		bracket,
+		// Anything that isn't a bracket or a string (symbols, numbers, etc).
+		atom,
+		// A token that ends with a closing ' or " quote.
+		string,
+		// A string token that contains \ escapes, these must be materialised
+		// with lisk::token_string before use.
+		escaped_string,
+	};
+
+	// A view of a single token in the source buffer that it was lexed from.
+	struct token
+	{
+		lisk::token_kind kind;
+		size_t offset;
+		size_t length;
+
+		inline std::string_view view(std::string_view source) const
+		{
+			return source.substr(offset, length);
+		}
+	};
+
+	struct lexer
+	{
+		std::string_view source;
+		size_t position = 0;
+
+		lexer(std::string_view src) : source(src) {}
+
+		// Reads the next complete token from source. Returns false if there are
+		// no more complete tokens, in which case position points to the start of
+		// the incomplete token (if any).
+		bool next(lisk::token &out);
+	};
+
+	lak::vector<lisk::token> lex(std::string_view str,
+	                             size_t *chars_used = nullptr);
+
+	// Get the text of a token, materialising any escape sequences.
+	lisk::string token_string(std::string_view source, const lisk::token &tok);
+
 	lak::vector<lisk::string> tokenise(const lisk::string &str,
 	                                   size_t *chars_used = nullptr);
 	lak::vector<lisk::string> root_tokenise(const lisk::string &str,
 	                                        size_t *chars_used = nullptr);
 
-	lisk::number parse_number(const lisk::string &token);
-	lisk::string parse_string(const lisk::string &token);
+	lisk::number parse_number(std::string_view token);
+	lisk::string parse_string(std::string_view token);
+	lisk::expression parse_atom(std::string_view token);
 	lisk::expression parse(const lak::vector<lisk::string> &tokens);
+	lisk::expression parse(std::string_view source,
+	                       const lak::vector<lisk::token> &tokens);
+	// Parse tokens as if they were wrapped in a (begin ...) expression.
+	lisk::expression root_parse(std::string_view source,
+	                            const lak::vector<lisk::token> &tokens);
+
+	// Lex and parse source in a single pass, without building a token list.
+	lisk::expression parse_source(std::string_view source);
+	lisk::expression root_parse_source(std::string_view source);
 
 	// Top level eval function.
 	lisk::expression eval_string(const lisk::string &str,
@@ -47,11 +119,22 @@ namespace lisk
 	lisk::expression root_eval_string(const lisk::string &str,
 	                                  lisk::environment &env);
 
-	// Delays evaluation of the expression.
+	// An expression that evaluates to value, for passing values that have
+	// already been evaluated to callables that evaluate their arguments. Values
+	// that evaluate to themselves are returned as they are, anything else is
+	// wrapped in a call to the quote builtin.
+	lisk::expression quoted(const lisk::expression &value);
+
+	// Evaluate the expression for (tail expr). In tail position of a lambda
+	// body this is handled by lisk::lambda::apply, which replaces the call
+	// frame instead.
 	lisk::expression tail_eval(lisk::expression expr,
 	                           lisk::environment &env,
 	                           bool allow_tail);
 
+	lisk::expression arithmetic_exception(const lisk::string &message,
+	                                      lisk::arithmetic_error err);
+
 	template<typename T>
 	lisk::expression type_error(const lisk::string &message,
 	                            const T &t,
@@ -109,6 +192,14 @@ namespace lisk
 
 		lisk::environment default_env();
 
+		// default_env, frozen so that any number of threads and runtimes can
+		// extend it at once.
+		const lisk::environment &shared_env();
+
+		// The functor that default_env binds to name, or nullptr. Used by the
+		// compilers to recognise the builtin special forms.
+		lisk::functor find_builtin(const lisk::symbol &name);
+
 		/* --- check --- */
 
 		lisk::expression null_check(lisk::environment &env,
@@ -144,6 +235,11 @@ namespace lisk
 		                          bool allow_tail,
 		                          lisk::expression exp);
 
+		// (quote exp) returns exp without evaluating it.
+		lisk::expression quote(lisk::environment &env,
+		                       bool allow_tail,
+		                       lisk::uneval_expr exp);
+
 		lak::pair<lisk::expression, size_t> evaluate_stack(lisk::shared_list l,
 		                                                   lisk::environment &env,
 		                                                   bool allow_tail);
@@ -166,14 +262,48 @@ namespace lisk
 		lisk::expression foreach (lisk::environment &env,
 		                          bool allow_tail,
 		                          lisk::symbol sym,
-		                          lisk::shared_list iterlist,
+		                          lisk::expression iterable,
 		                          lisk::uneval_expr exp);
 
 		lisk::expression map(lisk::environment &env,
 		                     bool allow_tail,
-		                     lisk::shared_list iterlist,
+		                     lisk::expression iterable,
 		                     lisk::uneval_expr exp);
 
+		// pmap, preduce and pfor split their elements into chunks that are run
+		// on this thread's worker pool (see lisk::get_worker_pool), so their
+		// functions and bodies run on several threads at once. They must not
+		// write to anything that another element can see. Lambdas, and pfor
+		// bodies, are safe as long as they only define things in their own
+		// frame, which define does unless it's called directly as the
+		// function. Builtins other than define, eval, read, print and println
+		// don't write to anything.
+		// Results come back in element order.
+
+		// Like map.
+		lisk::expression pmap(lisk::environment &env,
+		                      bool allow_tail,
+		                      lisk::expression iterable,
+		                      lisk::uneval_expr exp);
+
+		// (preduce iterable init f), folds the elements of every chunk with f,
+		// then folds the chunk results into init in order. This is the same as
+		// a left fold if f is associative. Chunking only depends on the number
+		// of elements, so the result doesn't depend on the number of threads.
+		lisk::expression preduce(lisk::environment &env,
+		                         bool allow_tail,
+		                         lisk::expression iterable,
+		                         lisk::expression init,
+		                         lisk::uneval_expr exp);
+
+		// Like foreach, but definitions made by the body don't outlive the
+		// element they were made for.
+		lisk::expression pfor(lisk::environment &env,
+		                      bool allow_tail,
+		                      lisk::symbol sym,
+		                      lisk::expression iterable,
+		                      lisk::uneval_expr exp);
+
 		lak::pair<lisk::expression, size_t> tail_call(lisk::shared_list l,
 		                                              lisk::environment &env,
 		                                              bool allow_tail);
@@ -211,6 +341,17 @@ namespace lisk
 		                                              lisk::environment &env,
 		                                              bool allow_tail);
 
+		lak::pair<lisk::expression, size_t> make_vector(lisk::shared_list l,
+		                                                lisk::environment &env,
+		                                                bool allow_tail);
+
+		// (hash-map key value key value ...), keys that are atoms are taken as
+		// written, so (hash-map a 1) has the symbol a as its key, anything else
+		// is evaluated first.
+		lak::pair<lisk::expression, size_t> make_hash_map(lisk::shared_list l,
+		                                                  lisk::environment &env,
+		                                                  bool allow_tail);
+
 		lak::pair<lisk::expression, size_t> make_lambda(lisk::shared_list l,
 		                                                lisk::environment &env,
 		                                                bool allow_tail);
@@ -277,6 +418,107 @@ namespace lisk
 		                                            lisk::environment &env,
 		                                            bool allow_tail);
 
+		/* --- vectors --- */
+
+		lisk::expression vector_length(lisk::environment &env,
+		                               bool allow_tail,
+		                               lisk::vector v);
+
+		lisk::expression vector_ref(lisk::environment &env,
+		                            bool allow_tail,
+		                            lisk::vector v,
+		                            lisk::uint_t index);
+
+		lisk::expression vector_slice(lisk::environment &env,
+		                              bool allow_tail,
+		                              lisk::vector v,
+		                              lisk::uint_t begin,
+		                              lisk::uint_t end);
+
+		lisk::expression vector_push(lisk::environment &env,
+		                             bool allow_tail,
+		                             lisk::vector v,
+		                             lisk::expression value);
+
+		/* --- hash maps --- */
+
+		// Keys are evaluated like any other argument, so (hash-get m k) looks
+		// up whatever k is bound to. Only hash-map takes atom keys as written.
+
+		lisk::expression hash_size(lisk::environment &env,
+		                           bool allow_tail,
+		                           lisk::hash_map m);
+
+		lisk::expression hash_get(lisk::environment &env,
+		                          bool allow_tail,
+		                          lisk::hash_map m,
+		                          lisk::expression key);
+
+		lisk::expression hash_contains(lisk::environment &env,
+		                               bool allow_tail,
+		                               lisk::hash_map m,
+		                               lisk::expression key);
+
+		lisk::expression hash_set(lisk::environment &env,
+		                          bool allow_tail,
+		                          lisk::hash_map m,
+		                          lisk::expression key,
+		                          lisk::expression value);
+
+		lisk::expression hash_remove(lisk::environment &env,
+		                             bool allow_tail,
+		                             lisk::hash_map m,
+		                             lisk::expression key);
+
+		lisk::expression hash_keys(lisk::environment &env,
+		                           bool allow_tail,
+		                           lisk::hash_map m);
+
+		/* --- numeric arrays --- */
+
+		lisk::expression make_array(lisk::environment &env,
+		                            bool allow_tail,
+		                            lisk::shared_list l);
+
+		lisk::expression array_list(lisk::environment &env,
+		                            bool allow_tail,
+		                            lak::shared_ptr<lisk::numeric_array> arr);
+
+		lisk::expression array_size(lisk::environment &env,
+		                            bool allow_tail,
+		                            lak::shared_ptr<lisk::numeric_array> arr);
+
+		lisk::expression array_sum(lisk::environment &env,
+		                           bool allow_tail,
+		                           lak::shared_ptr<lisk::numeric_array> arr);
+
+		lisk::expression array_product(lisk::environment &env,
+		                               bool allow_tail,
+		                               lak::shared_ptr<lisk::numeric_array> arr);
+
+		lisk::expression array_min(lisk::environment &env,
+		                           bool allow_tail,
+		                           lak::shared_ptr<lisk::numeric_array> arr);
+
+		lisk::expression array_max(lisk::environment &env,
+		                           bool allow_tail,
+		                           lak::shared_ptr<lisk::numeric_array> arr);
+
+		lisk::expression array_dot(lisk::environment &env,
+		                           bool allow_tail,
+		                           lak::shared_ptr<lisk::numeric_array> a,
+		                           lak::shared_ptr<lisk::numeric_array> b);
+
+		lisk::expression array_add(lisk::environment &env,
+		                           bool allow_tail,
+		                           lak::shared_ptr<lisk::numeric_array> a,
+		                           lak::shared_ptr<lisk::numeric_array> b);
+
+		lisk::expression array_mul(lisk::environment &env,
+		                           bool allow_tail,
+		                           lak::shared_ptr<lisk::numeric_array> a,
+		                           lak::shared_ptr<lisk::numeric_array> b);
+
 	};
 }
 
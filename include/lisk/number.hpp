@@ -1,20 +1,36 @@
 #ifndef LISK_NUMBER_HPP
 #	define LISK_NUMBER_HPP
 
+#	include "lisk/box.hpp"
 #	include "lisk/string.hpp"
 
 #	include <lak/result.hpp>
 #	include <lak/variant.hpp>
 
+#	include <cstdint>
+#	include <type_traits>
+
 namespace lisk
 {
 	using uint_t = unsigned long long;
 	using sint_t = signed long long;
+#	ifdef LISK_REAL_DOUBLE
+	using real_t = double;
+#	else
 	using real_t = long double;
+#	endif
+
+	// Reals that don't fit in the space of an integer are boxed so that a
+	// number stays 16 bytes.
+	using real_storage = std::conditional_t<(sizeof(lisk::real_t) >
+	                                         sizeof(lisk::uint_t)),
+	                                        lisk::box<lisk::real_t>,
+	                                        lisk::real_t>;
 
 	struct number
 	{
-		using value_type = lak::variant<lisk::uint_t, lisk::sint_t, lisk::real_t>;
+		using value_type =
+		  lak::variant<lisk::uint_t, lisk::sint_t, lisk::real_storage>;
 		value_type _value;
 
 		number()                = default;
@@ -49,13 +65,17 @@ namespace lisk
 		template<typename LAMBDA>
 		auto visit(LAMBDA &&lambda) const
 		{
-			return lak::visit(lambda, _value);
+			return lak::visit([&](auto &v) { return lambda(lisk::unbox(v)); },
+			                  _value);
 		}
 
+		// Boxed values are visited as const, write to them through the get_
+		// accessors.
 		template<typename LAMBDA>
 		auto visit(LAMBDA &&lambda)
 		{
-			return lak::visit(lambda, _value);
+			return lak::visit(
+			  [&](auto &v) { return lambda(lisk::visit_unbox(v)); }, _value);
 		}
 	};
 
@@ -71,6 +91,35 @@ namespace lisk
 	lisk::string to_string(lisk::real_t num);
 	const lisk::string &type_name(lisk::real_t);
 
+	enum struct arithmetic_error : uint8_t
+	{
+		none,
+		// The sint_t result doesn't fit, uint_t arithmetic wraps instead.
+		overflow,
+		// Integer division by zero, real division follows IEEE 754.
+		divide_by_zero,
+	};
+
+	lisk::string to_string(lisk::arithmetic_error err);
+
+	// Arithmetic with explicit overflow and division by zero checks, out is
+	// only written when this returns arithmetic_error::none and may alias a.
+	// Operands of the same type are dispatched on their type pair without
+	// visiting the variants, mixed operands promote with the usual arithmetic
+	// conversions (so uint_t and sint_t mix to uint_t).
+	inline lisk::arithmetic_error checked_add(const lisk::number &a,
+	                                          const lisk::number &b,
+	                                          lisk::number &out);
+	inline lisk::arithmetic_error checked_sub(const lisk::number &a,
+	                                          const lisk::number &b,
+	                                          lisk::number &out);
+	inline lisk::arithmetic_error checked_mul(const lisk::number &a,
+	                                          const lisk::number &b,
+	                                          lisk::number &out);
+	inline lisk::arithmetic_error checked_div(const lisk::number &a,
+	                                          const lisk::number &b,
+	                                          lisk::number &out);
+
 	struct expression;
 }
 
@@ -79,6 +128,7 @@ bool operator>>(const lisk::expression &arg, lisk::uint_t &out);
 bool operator>>(const lisk::expression &arg, lisk::sint_t &out);
 bool operator>>(const lisk::expression &arg, lisk::real_t &out);
 
+// These give a NaN real where lisk::checked_* would report an error.
 inline lisk::number operator+(lisk::number A, lisk::number B);
 inline lisk::number operator-(lisk::number A, lisk::number B);
 inline lisk::number operator*(lisk::number A, lisk::number B);
@@ -2,6 +2,9 @@
 
 #include "lisk/expression.hpp"
 
+#include <limits>
+#include <type_traits>
+
 /* --- constructor --- */
 
 inline lisk::number::number(lisk::uint_t u)
@@ -15,7 +18,7 @@ inline lisk::number::number(lisk::sint_t s)
 }
 
 inline lisk::number::number(lisk::real_t r)
-: _value(lak::in_place_index<value_type::index_of<lisk::real_t>>, r)
+: _value(lak::in_place_index<value_type::index_of<lisk::real_storage>>, r)
 {
 }
 
@@ -35,7 +38,7 @@ inline lisk::number &lisk::number::operator=(lisk::sint_t s)
 
 inline lisk::number &lisk::number::operator=(lisk::real_t r)
 {
-	_value.emplace<value_type::index_of<lisk::real_t>>(r);
+	_value.emplace<value_type::index_of<lisk::real_storage>>(r);
 	return *this;
 }
 
@@ -51,7 +54,7 @@ inline bool lisk::number::is_sint() const
 
 inline bool lisk::number::is_real() const
 {
-	return _value.holds<value_type::index_of<lisk::real_t>>();
+	return _value.holds<value_type::index_of<lisk::real_storage>>();
 }
 
 inline lak::result<lisk::uint_t &> lisk::number::get_uint() &
@@ -86,49 +89,310 @@ inline lak::result<lisk::sint_t> lisk::number::get_sint() &&
 
 inline lak::result<lisk::real_t &> lisk::number::get_real() &
 {
-	return lak::get<lisk::real_t>(_value);
+	return lak::get<lisk::real_storage>(_value).and_then(
+	  [](lisk::real_storage &r)
+	  { return lak::result_from_pointer(&lisk::unbox(r)); });
 }
 
 inline lak::result<const lisk::real_t &> lisk::number::get_real() const &
 {
-	return lak::get<lisk::real_t>(_value);
+	return lak::get<lisk::real_storage>(_value).and_then(
+	  [](const lisk::real_storage &r)
+	  { return lak::result_from_pointer(&lisk::unbox(r)); });
 }
 
 inline lak::result<lisk::real_t> lisk::number::get_real() &&
 {
-	return lak::get<lisk::real_t>(lak::move(_value));
+	return lak::get<lisk::real_storage>(_value).and_then(
+	  [](const lisk::real_storage &r) -> lak::result<lisk::real_t>
+	  { return lak::ok_t<lisk::real_t>{lisk::unbox(r)}; });
+}
+
+/* --- checked arithmetic --- */
+
+namespace lisk::impl
+{
+	template<typename T>
+	constexpr size_t number_index =
+	  lisk::number::value_type::index_of<std::conditional_t<
+	    std::is_same_v<T, lisk::real_t>,
+	    lisk::real_storage,
+	    T>>;
+
+	// Store value in out without rebuilding the variant if out already holds a
+	// T, so accumulating into a number stays in the native type.
+	template<typename T>
+	inline void set_number(lisk::number &out, T value)
+	{
+		if (auto *p = out._value.template get<number_index<T>>(); p)
+			lisk::unbox(*p) = value;
+		else
+			out = value;
+	}
+
+	inline bool add_overflows(lisk::sint_t a, lisk::sint_t b, lisk::sint_t &out)
+	{
+#if defined(__GNUC__) || defined(__clang__)
+		return __builtin_add_overflow(a, b, &out);
+#else
+		constexpr auto max = std::numeric_limits<lisk::sint_t>::max();
+		constexpr auto min = std::numeric_limits<lisk::sint_t>::min();
+		if (b > 0 ? a > max - b : a < min - b) return true;
+		out = a + b;
+		return false;
+#endif
+	}
+
+	inline bool sub_overflows(lisk::sint_t a, lisk::sint_t b, lisk::sint_t &out)
+	{
+#if defined(__GNUC__) || defined(__clang__)
+		return __builtin_sub_overflow(a, b, &out);
+#else
+		constexpr auto max = std::numeric_limits<lisk::sint_t>::max();
+		constexpr auto min = std::numeric_limits<lisk::sint_t>::min();
+		if (b > 0 ? a < min + b : a > max + b) return true;
+		out = a - b;
+		return false;
+#endif
+	}
+
+	inline bool mul_overflows(lisk::sint_t a, lisk::sint_t b, lisk::sint_t &out)
+	{
+#if defined(__GNUC__) || defined(__clang__)
+		return __builtin_mul_overflow(a, b, &out);
+#else
+		constexpr auto max = std::numeric_limits<lisk::sint_t>::max();
+		constexpr auto min = std::numeric_limits<lisk::sint_t>::min();
+		if (a > 0 ? (b > 0 ? a > max / b : b < min / a)
+		          : (b > 0 ? a < min / b : a != 0 && b < max / a))
+			return true;
+		out = a * b;
+		return false;
+#endif
+	}
+
+	struct add_op
+	{
+		static lisk::arithmetic_error apply(lisk::uint_t a,
+		                                    lisk::uint_t b,
+		                                    lisk::number &out)
+		{
+			set_number(out, lisk::uint_t(a + b));
+			return lisk::arithmetic_error::none;
+		}
+
+		static lisk::arithmetic_error apply(lisk::sint_t a,
+		                                    lisk::sint_t b,
+		                                    lisk::number &out)
+		{
+			lisk::sint_t result;
+			if (add_overflows(a, b, result))
+				return lisk::arithmetic_error::overflow;
+			set_number(out, result);
+			return lisk::arithmetic_error::none;
+		}
+
+		static lisk::arithmetic_error apply(lisk::real_t a,
+		                                    lisk::real_t b,
+		                                    lisk::number &out)
+		{
+			set_number(out, lisk::real_t(a + b));
+			return lisk::arithmetic_error::none;
+		}
+	};
+
+	struct sub_op
+	{
+		static lisk::arithmetic_error apply(lisk::uint_t a,
+		                                    lisk::uint_t b,
+		                                    lisk::number &out)
+		{
+			set_number(out, lisk::uint_t(a - b));
+			return lisk::arithmetic_error::none;
+		}
+
+		static lisk::arithmetic_error apply(lisk::sint_t a,
+		                                    lisk::sint_t b,
+		                                    lisk::number &out)
+		{
+			lisk::sint_t result;
+			if (sub_overflows(a, b, result))
+				return lisk::arithmetic_error::overflow;
+			set_number(out, result);
+			return lisk::arithmetic_error::none;
+		}
+
+		static lisk::arithmetic_error apply(lisk::real_t a,
+		                                    lisk::real_t b,
+		                                    lisk::number &out)
+		{
+			set_number(out, lisk::real_t(a - b));
+			return lisk::arithmetic_error::none;
+		}
+	};
+
+	struct mul_op
+	{
+		static lisk::arithmetic_error apply(lisk::uint_t a,
+		                                    lisk::uint_t b,
+		                                    lisk::number &out)
+		{
+			set_number(out, lisk::uint_t(a * b));
+			return lisk::arithmetic_error::none;
+		}
+
+		static lisk::arithmetic_error apply(lisk::sint_t a,
+		                                    lisk::sint_t b,
+		                                    lisk::number &out)
+		{
+			lisk::sint_t result;
+			if (mul_overflows(a, b, result))
+				return lisk::arithmetic_error::overflow;
+			set_number(out, result);
+			return lisk::arithmetic_error::none;
+		}
+
+		static lisk::arithmetic_error apply(lisk::real_t a,
+		                                    lisk::real_t b,
+		                                    lisk::number &out)
+		{
+			set_number(out, lisk::real_t(a * b));
+			return lisk::arithmetic_error::none;
+		}
+	};
+
+	struct div_op
+	{
+		static lisk::arithmetic_error apply(lisk::uint_t a,
+		                                    lisk::uint_t b,
+		                                    lisk::number &out)
+		{
+			if (b == 0) return lisk::arithmetic_error::divide_by_zero;
+			set_number(out, lisk::uint_t(a / b));
+			return lisk::arithmetic_error::none;
+		}
+
+		static lisk::arithmetic_error apply(lisk::sint_t a,
+		                                    lisk::sint_t b,
+		                                    lisk::number &out)
+		{
+			if (b == 0) return lisk::arithmetic_error::divide_by_zero;
+			if (b == -1 && a == std::numeric_limits<lisk::sint_t>::min())
+				return lisk::arithmetic_error::overflow;
+			set_number(out, lisk::sint_t(a / b));
+			return lisk::arithmetic_error::none;
+		}
+
+		static lisk::arithmetic_error apply(lisk::real_t a,
+		                                    lisk::real_t b,
+		                                    lisk::number &out)
+		{
+			set_number(out, lisk::real_t(a / b));
+			return lisk::arithmetic_error::none;
+		}
+	};
+
+	template<typename OP>
+	inline lisk::arithmetic_error checked_arithmetic(const lisk::number &a,
+	                                                 const lisk::number &b,
+	                                                 lisk::number &out)
+	{
+		constexpr size_t uint_index = number_index<lisk::uint_t>;
+		constexpr size_t sint_index = number_index<lisk::sint_t>;
+		constexpr size_t real_index = number_index<lisk::real_t>;
+
+		if (const size_t index = a._value.index(); index == b._value.index())
+		{
+			switch (index)
+			{
+				case uint_index:
+					return OP::apply(*a._value.template get<uint_index>(),
+					                 *b._value.template get<uint_index>(),
+					                 out);
+				case sint_index:
+					return OP::apply(*a._value.template get<sint_index>(),
+					                 *b._value.template get<sint_index>(),
+					                 out);
+				case real_index:
+					return OP::apply(
+					  lisk::unbox(*a._value.template get<real_index>()),
+					  lisk::unbox(*b._value.template get<real_index>()),
+					  out);
+			}
+		}
+
+		return a.visit(
+		  [&](const auto &x)
+		  {
+			  return b.visit(
+			    [&](const auto &y)
+			    {
+				    using type = std::common_type_t<std::remove_cvref_t<decltype(x)>,
+				                                    std::remove_cvref_t<decltype(y)>>;
+				    return OP::apply(type(x), type(y), out);
+			    });
+		  });
+	}
+
+	template<typename OP>
+	inline lisk::number unchecked_arithmetic(const lisk::number &a,
+	                                         const lisk::number &b)
+	{
+		lisk::number result;
+		if (checked_arithmetic<OP>(a, b, result) != lisk::arithmetic_error::none)
+			result = std::numeric_limits<lisk::real_t>::quiet_NaN();
+		return result;
+	}
+}
+
+lisk::arithmetic_error lisk::checked_add(const lisk::number &a,
+                                         const lisk::number &b,
+                                         lisk::number &out)
+{
+	return lisk::impl::checked_arithmetic<lisk::impl::add_op>(a, b, out);
 }
 
+lisk::arithmetic_error lisk::checked_sub(const lisk::number &a,
+                                         const lisk::number &b,
+                                         lisk::number &out)
+{
+	return lisk::impl::checked_arithmetic<lisk::impl::sub_op>(a, b, out);
+}
+
+lisk::arithmetic_error lisk::checked_mul(const lisk::number &a,
+                                         const lisk::number &b,
+                                         lisk::number &out)
+{
+	return lisk::impl::checked_arithmetic<lisk::impl::mul_op>(a, b, out);
+}
+
+lisk::arithmetic_error lisk::checked_div(const lisk::number &a,
+                                         const lisk::number &b,
+                                         lisk::number &out)
+{
+	return lisk::impl::checked_arithmetic<lisk::impl::div_op>(a, b, out);
+}
+
+/* --- operators --- */
+
 lisk::number operator+(lisk::number A, lisk::number B)
 {
-	return lak::visit([](auto &&A, auto &&B) -> lisk::number
-	                  { return lisk::number(A + B); },
-	                  A._value,
-	                  B._value);
+	return lisk::impl::unchecked_arithmetic<lisk::impl::add_op>(A, B);
 }
 
 lisk::number operator-(lisk::number A, lisk::number B)
 {
-	return lak::visit([](auto &&A, auto &&B) -> lisk::number
-	                  { return lisk::number(A - B); },
-	                  A._value,
-	                  B._value);
+	return lisk::impl::unchecked_arithmetic<lisk::impl::sub_op>(A, B);
 }
 
 lisk::number operator*(lisk::number A, lisk::number B)
 {
-	return lak::visit([](auto &&A, auto &&B) -> lisk::number
-	                  { return lisk::number(A * B); },
-	                  A._value,
-	                  B._value);
+	return lisk::impl::unchecked_arithmetic<lisk::impl::mul_op>(A, B);
 }
 
 lisk::number operator/(lisk::number A, lisk::number B)
 {
-	return lak::visit([](auto &&A, auto &&B) -> lisk::number
-	                  { return lisk::number(A / B); },
-	                  A._value,
-	                  B._value);
+	return lisk::impl::unchecked_arithmetic<lisk::impl::div_op>(A, B);
 }
 
 lisk::number &operator+=(lisk::number &A, lisk::number B)
@@ -0,0 +1,89 @@
+#ifndef LISK_NUMERIC_ARRAY_HPP
+#define LISK_NUMERIC_ARRAY_HPP
+
+#define LISK_NUMBER_FORWARD_ONLY
+#include "lisk/number.hpp"
+
+#define LISK_SHARED_LIST_FORWARD_ONLY
+#include "lisk/shared_list.hpp"
+
+#include <lak/array.hpp>
+#include <lak/result.hpp>
+#include <lak/variant.hpp>
+
+namespace lisk
+{
+	struct expression;
+
+	using shared_list = lisk::basic_shared_list<lisk::expression>;
+
+	// A packed array of numbers that all have the same type, for reductions
+	// over large data sets. Unlike a list of numbers this is contiguous, so
+	// its kernels run over native values several at a time. Lisk code holds
+	// these as managed pointers, converting from and to lists is explicit.
+	struct numeric_array
+	{
+		using value_type = lak::variant<lak::vector<lisk::uint_t>,
+		                                lak::vector<lisk::sint_t>,
+		                                lak::vector<lisk::real_t>>;
+		value_type _value;
+
+		numeric_array()                      = default;
+		numeric_array(const numeric_array &) = default;
+		numeric_array(numeric_array &&)      = default;
+
+		numeric_array &operator=(const numeric_array &) = default;
+		numeric_array &operator=(numeric_array &&) = default;
+
+		numeric_array(lak::vector<lisk::uint_t> values);
+		numeric_array(lak::vector<lisk::sint_t> values);
+		numeric_array(lak::vector<lisk::real_t> values);
+
+		size_t size() const;
+
+		lisk::number operator[](size_t index) const;
+
+		template<typename LAMBDA>
+		auto visit(LAMBDA &&lambda) const
+		{
+			return lak::visit(lambda, _value);
+		}
+	};
+
+	lisk::string to_string(const lisk::numeric_array &arr);
+	const lisk::string &type_name(const lisk::numeric_array &);
+
+	// Fails if any element of l isn't a number. Elements are promoted to a
+	// common type: any real, or a mix of sints and uints, makes a real array,
+	// otherwise the array has the type of its elements.
+	lak::result<lisk::numeric_array> to_numeric_array(const lisk::shared_list &l);
+
+	lisk::shared_list to_list(const lisk::numeric_array &arr);
+
+	// Reductions follow the lisk::checked_* rules, except that sint sums only
+	// report overflow if the exact result doesn't fit and reals are summed in
+	// several lanes, so they can round differently to a sequential sum. Empty
+	// arrays sum to 0 and multiply to 1.
+	lisk::arithmetic_error array_sum(const lisk::numeric_array &arr,
+	                                 lisk::number &out);
+	lisk::arithmetic_error array_product(const lisk::numeric_array &arr,
+	                                     lisk::number &out);
+	// These return false for empty arrays.
+	bool array_min(const lisk::numeric_array &arr, lisk::number &out);
+	bool array_max(const lisk::numeric_array &arr, lisk::number &out);
+
+	// Element-wise operations, a and b must have the same size. Arrays of
+	// different types are promoted to their common type first, which is real
+	// for a sint and a uint array.
+	lisk::arithmetic_error array_dot(const lisk::numeric_array &a,
+	                                 const lisk::numeric_array &b,
+	                                 lisk::number &out);
+	lisk::arithmetic_error array_add(const lisk::numeric_array &a,
+	                                 const lisk::numeric_array &b,
+	                                 lisk::numeric_array &out);
+	lisk::arithmetic_error array_mul(const lisk::numeric_array &a,
+	                                 const lisk::numeric_array &b,
+	                                 lisk::numeric_array &out);
+}
+
+#endif
@@ -0,0 +1,111 @@
+#ifndef LISK_RUNTIME_HPP
+#define LISK_RUNTIME_HPP
+
+#include "lisk/allocator.hpp"
+#include "lisk/environment.hpp"
+#include "lisk/worker_pool.hpp"
+
+#define LISK_EXPRESSION_FORWARD_ONLY
+#include "lisk/expression.hpp"
+
+#include "lisk/string.hpp"
+
+#include <cstddef>
+#include <deque>
+
+namespace lisk
+{
+	struct runtime_options
+	{
+		// Threads that the parallel builtins use, including the one that runs
+		// the script. 0 uses std::thread::hardware_concurrency().
+		size_t threads = 1;
+		// The most bytes of node memory the runtime may take from the heap, 0
+		// for no limit. Nodes that one thread's arena has cached can't be
+		// reused by another, so with more than one thread less of the limit
+		// may be usable.
+		size_t memory_limit = 0;
+		// The evaluation steps each call to eval or eval_string may take, 0
+		// for no limit (see lisk::eval_step_budget).
+		size_t step_budget = 0;
+	};
+
+	struct runtime_stats
+	{
+		// Summed over the runtime's arenas. Nodes freed by a thread other than
+		// the one that allocated them are only counted once that thread has
+		// taken them back.
+		lisk::allocation_stats nodes;
+		size_t bytes_reserved = 0;
+		size_t evaluations    = 0;
+		// Steps taken from the runtime's step budget.
+		size_t steps = 0;
+	};
+
+	// Everything a script allocates while it runs: the nodes of its values and
+	// environments come from arenas that are freed all at once when the
+	// runtime is destroyed, and the parallel builtins run on the runtime's own
+	// worker pool. Each worker thread allocates from an arena of its own,
+	// which counts against the same memory limit. Scripts see the builtins
+	// through a frozen environment that every runtime shares.
+	//
+	// A runtime may only be used by one thread at a time, different runtimes
+	// can be used by different threads at once. Values taken out of a runtime
+	// must be destroyed before it is.
+	//
+	// Runtimes aren't entirely free of shared locks: every runtime interns its
+	// symbols into the one symbol table, which takes a shared lock to look a
+	// name up and an exclusive lock the first time a name is seen, and each
+	// arena registers with lisk::collect_cycles when it's made and destroyed.
+	// Evaluation and teardown otherwise only lock the runtime's own arenas.
+	struct runtime
+	{
+		// Declared first so that they're destroyed last.
+		lisk::arena_allocator _arena;
+		std::deque<lisk::arena_allocator> _worker_arenas;
+		lisk::worker_pool _pool;
+		lisk::environment _env;
+		size_t _step_budget = 0;
+		size_t _evaluations = 0;
+		size_t _steps       = 0;
+
+		// Selects the runtime's allocator and worker pool on this thread for
+		// as long as it exists.
+		struct scope
+		{
+			lisk::node_allocator *previous_allocator;
+			lisk::worker_pool *previous_pool;
+
+			explicit scope(lisk::runtime &rt);
+			~scope();
+
+			scope(const scope &)            = delete;
+			scope &operator=(const scope &) = delete;
+		};
+
+		explicit runtime(const lisk::runtime_options &options = {});
+		~runtime();
+
+		runtime(const runtime &)            = delete;
+		runtime &operator=(const runtime &) = delete;
+
+		// Calls f(env()) with the runtime selected on this thread.
+		template<typename F>
+		decltype(auto) run(F &&f)
+		{
+			scope s(*this);
+			return f(_env);
+		}
+
+		// Evaluate in the runtime's global environment. Running out of memory
+		// or steps returns an exception.
+		lisk::expression eval(const lisk::expression &exp, bool allow_tail = true);
+		lisk::expression eval_string(const lisk::string &source);
+
+		lisk::environment &env() { return _env; }
+
+		lisk::runtime_stats stats() const;
+	};
+}
+
+#endif
@@ -1,27 +1,81 @@
 #ifndef LISK_SHARED_LIST_HPP
 #	define LISK_SHARED_LIST_HPP
 
+#	include "lisk/allocator.hpp"
 #	include "lisk/string.hpp"
 
-#	include <lak/memory.hpp>
+#	include <lak/array.hpp>
+
+#	include <cstdint>
 
 namespace lisk
 {
 	template<typename T>
 	struct basic_shared_list_node
 	{
-		using pointer_type = lak::shared_ptr<basic_shared_list_node>;
+		using pointer_type = lisk::node_ptr<basic_shared_list_node>;
 
 		T value;
 		pointer_type next;
 
+		basic_shared_list_node()                               = default;
+		basic_shared_list_node(const basic_shared_list_node &) = default;
+		basic_shared_list_node &operator=(const basic_shared_list_node &) = default;
+
+		// Releases the rest of the list iteratively, and hands values that own
+		// nodes (T::owns_nodes) to this thread's release queue, so dropping a
+		// long or deeply nested list doesn't recurse.
+		~basic_shared_list_node();
+
 		static pointer_type create();
 	};
 
+	// Stop destroyed nodes from releasing the rest of their list straight
+	// away on this thread, leaving that to release_deferred instead.
+	void set_deferred_release(bool defer);
+	bool deferred_release();
+
+	// Release up to max_nodes of the nodes this thread has deferred, returns
+	// the number of nodes and values still waiting to be released.
+	size_t release_deferred(size_t max_nodes = SIZE_MAX);
+
+	namespace impl
+	{
+		struct release_queue_base
+		{
+			bool releasing = false;
+
+			virtual ~release_queue_base() = default;
+			// Returns the number of nodes released.
+			virtual size_t release(size_t max_nodes) = 0;
+			virtual size_t pending() const           = 0;
+		};
+
+		void register_release_queue(release_queue_base *queue);
+		void unregister_release_queue(release_queue_base *queue);
+
+		template<typename T>
+		struct release_queue final : release_queue_base
+		{
+			lak::vector<typename lisk::basic_shared_list_node<T>::pointer_type> nodes;
+			lak::vector<T> values;
+
+			release_queue();
+			~release_queue();
+
+			size_t release(size_t max_nodes) override;
+			size_t pending() const override;
+
+			// This thread's queue, or nullptr once it has been destroyed.
+			static release_queue *get();
+			static bool &destroyed();
+		};
+	}
+
 	template<typename T>
 	struct basic_shared_list
 	{
-		mutable lak::shared_ptr<lisk::basic_shared_list_node<T>> _node = {};
+		mutable lisk::node_ptr<lisk::basic_shared_list_node<T>> _node = {};
 
 		static basic_shared_list create();
 
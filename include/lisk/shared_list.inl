@@ -2,6 +2,108 @@
 
 #include "lisk/expression.hpp"
 
+template<typename T>
+lisk::basic_shared_list_node<T>::~basic_shared_list_node()
+{
+	// Only nodes that this is the last reference to would be destroyed.
+	const bool release_next = next && next.use_count() == 1;
+	// Values that don't hold nodes (most frames only bind numbers) can't
+	// recurse, so they're destroyed in place rather than queued.
+	const bool release_value = value.owns_nodes();
+
+	if (!release_next && !release_value) return;
+
+	const bool deferred = lisk::deferred_release();
+
+	if (release_next && !deferred)
+	{
+		// Unlink the rest of the chain one node at a time, each node is
+		// destroyed with its next already taken.
+		for (pointer_type node = lak::move(next); node && node.use_count() == 1;)
+		{
+			pointer_type after = lak::move(node->next);
+			node               = lak::move(after);
+		}
+	}
+
+	if (!(release_value || (release_next && deferred))) return;
+
+	auto *queue = lisk::impl::release_queue<T>::get();
+	// The thread is exiting, fall back to recursive destruction.
+	if (!queue) return;
+
+	if (release_next && deferred) queue->nodes.push_back(lak::move(next));
+
+	if (release_value)
+	{
+		queue->values.push_back(lak::move(value));
+		if (!queue->releasing && !deferred) queue->release(SIZE_MAX);
+	}
+}
+
+template<typename T>
+lisk::impl::release_queue<T>::release_queue()
+{
+	lisk::impl::register_release_queue(this);
+}
+
+template<typename T>
+lisk::impl::release_queue<T>::~release_queue()
+{
+	release(SIZE_MAX);
+	lisk::impl::unregister_release_queue(this);
+	destroyed() = true;
+}
+
+template<typename T>
+size_t lisk::impl::release_queue<T>::release(size_t max_nodes)
+{
+	if (releasing) return 0;
+	releasing = true;
+
+	// Anything released here pushes what it owns back onto the queue rather
+	// than releasing it recursively.
+	size_t released = 0;
+	while (released < max_nodes && (!nodes.empty() || !values.empty()))
+	{
+		if (!values.empty())
+		{
+			[[maybe_unused]] T value = lak::move(values.back());
+			values.pop_back();
+		}
+		else
+		{
+			[[maybe_unused]] auto node = lak::move(nodes.back());
+			nodes.pop_back();
+			++released;
+		}
+	}
+
+	releasing = false;
+	return released;
+}
+
+template<typename T>
+size_t lisk::impl::release_queue<T>::pending() const
+{
+	return nodes.size() + values.size();
+}
+
+template<typename T>
+bool &lisk::impl::release_queue<T>::destroyed()
+{
+	thread_local bool result = false;
+	return result;
+}
+
+template<typename T>
+lisk::impl::release_queue<T> *lisk::impl::release_queue<T>::get()
+{
+	if (destroyed()) return nullptr;
+	thread_local release_queue queue;
+	return &queue;
+}
+
 template<typename T>
 typename lisk::basic_shared_list_node<T>::pointer_type
 lisk::basic_shared_list_node<T>::create()
@@ -4,38 +4,53 @@
 #include <lak/string.hpp>
 #include <lak/utility.hpp>
 
+#include <cstdint>
+#include <string_view>
+
 namespace lisk
 {
-	struct symbol : public lak::astring
+	struct string;
+
+	// Symbols are interned into a process-wide table, a symbol is just the
+	// 32-bit id of its name so comparing and hashing symbols never touches the
+	// name itself. Interned names are never freed, and interning a name once
+	// every id is taken throws std::length_error.
+	struct symbol
 	{
+		using id_type = uint32_t;
+
+		// id 0 is always the empty symbol.
+		id_type id = 0;
+
 		symbol()               = default;
 		symbol(const symbol &) = default;
 		symbol(symbol &&)      = default;
 
-		symbol(const lak::astring &value) : lak::astring(value) {}
-		symbol(lak::astring &&value) : lak::astring(lak::move(value)) {}
-		symbol(const char *value) : lak::astring(value) {}
+		symbol(std::string_view value);
+		explicit symbol(const lak::astring &value)
+		: symbol(std::string_view(value))
+		{
+		}
+		symbol(const char *value) : symbol(std::string_view(value)) {}
 
 		symbol &operator=(const symbol &) = default;
 		symbol &operator=(symbol &&) = default;
 
-		symbol &operator=(const lak::astring &value)
-		{
-			lak::astring::operator=(value);
-			return *this;
-		}
-		symbol &operator=(lak::astring &&value)
-		{
-			lak::astring::operator=(lak::move(value));
-			return *this;
-		}
-		symbol &operator=(const char *value)
-		{
-			lak::astring::operator=(value);
-			return *this;
-		}
+		// The returned reference is valid for the lifetime of the program.
+		const lisk::string &name() const;
 
-		using lak::astring::operator[];
+		bool operator==(const symbol &) const = default;
+	};
+
+	// A symbol that lisk::lambda resolved to a slot in one of its call frames.
+	// depth counts frames outwards from the lambda's own call frame. The
+	// address is checked against the frame on lookup, so a stale address falls
+	// back to looking sym up by name.
+	struct resolved_symbol
+	{
+		lisk::symbol sym;
+		uint32_t depth = 0;
+		uint32_t slot  = 0;
 	};
 
 	struct string : public lak::astring
@@ -73,6 +88,9 @@ namespace lisk
 	lisk::string to_string(const lisk::symbol &sym);
 	const lisk::string &type_name(const lisk::symbol &);
 
+	lisk::string to_string(const lisk::resolved_symbol &sym);
+	const lisk::string &type_name(const lisk::resolved_symbol &);
+
 	lisk::string to_string(const lisk::string &str);
 	const lisk::string &type_name(const lisk::string &);
 
@@ -83,8 +101,12 @@ bool operator>>(const lisk::expression &arg, lisk::symbol &out);
 bool operator>>(const lisk::expression &arg, lisk::string &out);
 
 template<>
-struct std::hash<lisk::symbol> : public std::hash<lak::astring>
+struct std::hash<lisk::symbol>
 {
+	size_t operator()(const lisk::symbol &sym) const noexcept
+	{
+		return std::hash<lisk::symbol::id_type>{}(sym.id);
+	}
 };
 template<>
 struct std::hash<lisk::string> : public std::hash<lak::astring>
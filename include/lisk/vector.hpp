@@ -0,0 +1,105 @@
+#ifndef LISK_VECTOR_HPP
+#	define LISK_VECTOR_HPP
+
+#	include "lisk/allocator.hpp"
+#	include "lisk/string.hpp"
+
+#	include <lak/result.hpp>
+
+namespace lisk
+{
+	struct expression;
+	struct vector_leaf;
+	struct vector_branch;
+	struct vector_data;
+
+	// Vector of expressions with structural sharing. Elements are kept in
+	// contiguous leaves of a 32-way trie, plus a tail leaf that pushes go to
+	// (the layout of Clojure's PersistentVector), so indexing and pushing are
+	// O(log32 n) and a modified copy shares everything but the path to the
+	// leaf that changed.
+	//
+	// Lisk code only ever sees vectors as values. In C++ a vector behaves like
+	// a copy-on-write value: modifying one copies the nodes that are shared
+	// with other vectors and modifies the rest in place, so building a vector
+	// up with push_back doesn't copy anything.
+	//
+	// A vector is a view of [_offset, _offset + _size) of its data, which
+	// makes slicing O(1) but keeps the rest of the data alive.
+	struct vector
+	{
+		static constexpr size_t bits  = 5;
+		static constexpr size_t width = size_t(1) << bits;
+
+		lisk::node_ptr<lisk::vector_data> _data;
+		size_t _offset = 0;
+		size_t _size   = 0;
+
+		vector()                = default;
+		vector(const vector &v) = default;
+		vector(vector &&v)      = default;
+
+		vector &operator=(const vector &v) = default;
+		vector &operator=(vector &&v) = default;
+
+		inline size_t size() const { return _size; }
+		inline bool empty() const { return _size == 0; }
+
+		// index must be less than size().
+		inline const lisk::expression &operator[](size_t index) const;
+
+		lak::result<const lisk::expression &> at(size_t index) const;
+
+		void push_back(lisk::expression value);
+
+		// index must be less than size().
+		void set(size_t index, lisk::expression value);
+
+		// The elements [begin, end), both must be no greater than size().
+		lisk::vector slice(size_t begin, size_t end) const;
+
+		// The leaf holding the element at index into _data.
+		const lisk::expression *leaf(size_t index) const;
+
+		struct iterator
+		{
+			const lisk::vector *_vector      = nullptr;
+			size_t _index                    = 0;
+			const lisk::expression *_values = nullptr;
+
+			inline const lisk::expression &operator*() const;
+			inline const lisk::expression *operator->() const;
+
+			inline iterator &operator++();
+
+			inline bool operator==(const iterator &other) const
+			{
+				return _index == other._index;
+			}
+			inline bool operator!=(const iterator &other) const
+			{
+				return _index != other._index;
+			}
+		};
+
+		inline iterator begin() const;
+		inline iterator end() const;
+	};
+
+	lisk::string to_string(const lisk::vector &v);
+	const lisk::string &type_name(const lisk::vector &);
+}
+
+bool operator>>(const lisk::expression &arg, lisk::vector &out);
+
+#	define LISK_VECTOR_HPP_FINISHED
+#endif
+
+#ifdef LISK_VECTOR_FORWARD_ONLY
+#	undef LISK_VECTOR_FORWARD_ONLY
+#else
+#	if defined(LISK_VECTOR_HPP_FINISHED) && !defined(LISK_VECTOR_HPP_IMPL)
+#		define LISK_VECTOR_HPP_IMPL
+#		include "vector.inl"
+#	endif
+#endif
@@ -0,0 +1,79 @@
+#include "vector.hpp"
+
+#include "lisk/expression.hpp"
+
+namespace lisk
+{
+	struct vector_leaf
+	{
+		lisk::expression values[lisk::vector::width];
+
+		vector_leaf()                    = default;
+		vector_leaf(const vector_leaf &) = default;
+
+		// Hands values that own nodes to this thread's release queue, so
+		// dropping deeply nested vectors doesn't recurse.
+		~vector_leaf();
+	};
+
+	struct vector_branch
+	{
+		// Children are leaves at the bottom level of the trie and branches
+		// above it, only one of these is used.
+		lisk::node_ptr<lisk::vector_leaf> leaves[lisk::vector::width];
+		lisk::node_ptr<lisk::vector_branch> branches[lisk::vector::width];
+	};
+
+	struct vector_data
+	{
+		// Null until the tail first fills up.
+		lisk::node_ptr<lisk::vector_branch> root;
+		// Holds the elements from tail_offset() to count.
+		lisk::node_ptr<lisk::vector_leaf> tail;
+		size_t count = 0;
+		// The level of root, its children are leaves when shift == bits.
+		size_t shift = lisk::vector::bits;
+
+		size_t tail_offset() const
+		{
+			return count < lisk::vector::width
+			         ? 0
+			         : ((count - 1) >> lisk::vector::bits) << lisk::vector::bits;
+		}
+	};
+}
+
+const lisk::expression &lisk::vector::operator[](size_t index) const
+{
+	index += _offset;
+	return leaf(index)[index & (width - 1)];
+}
+
+const lisk::expression &lisk::vector::iterator::operator*() const
+{
+	return _values[(_vector->_offset + _index) & (width - 1)];
+}
+
+const lisk::expression *lisk::vector::iterator::operator->() const
+{
+	return &**this;
+}
+
+lisk::vector::iterator &lisk::vector::iterator::operator++()
+{
+	// Only look up the next leaf when crossing into it.
+	if (const size_t index = _vector->_offset + ++_index;
+	    (index & (width - 1)) == 0 && _index < _vector->_size)
+		_values = _vector->leaf(index);
+	return *this;
+}
+
+lisk::vector::iterator lisk::vector::begin() const
+{
+	return {this, 0, _size ? leaf(_offset) : nullptr};
+}
+
+lisk::vector::iterator lisk::vector::end() const
+{
+	return {this, _size, nullptr};
+}
@@ -0,0 +1,123 @@
+#ifndef LISK_WORKER_POOL_HPP
+#define LISK_WORKER_POOL_HPP
+
+#include <lak/array.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+
+namespace lisk
+{
+	// A fixed set of threads that run batches of tasks. Every thread has its
+	// own deque of tasks, it takes tasks from the back of its own deque and
+	// steals from the front of the others' when that's empty. Threads that
+	// wait for a batch run tasks while they wait, so batches can be started
+	// from inside tasks, and block once there are none left to take.
+	//
+	// With LISK_SINGLE_THREADED defined lisk values can't cross threads, so
+	// pools have no threads and batches run on the calling thread.
+	struct worker_pool
+	{
+		struct batch
+		{
+			void (*call)(void *context, size_t begin, size_t end) = nullptr;
+			void *context                                          = nullptr;
+			std::atomic<size_t> pending                            = 0;
+			std::mutex error_mutex;
+			std::exception_ptr error;
+			// The thread that started the batch waits on done once it can't
+			// find any more tasks to run.
+			std::mutex done_mutex;
+			std::condition_variable done;
+		};
+
+		struct task
+		{
+			lisk::worker_pool::batch *owner;
+			size_t begin;
+			size_t end;
+		};
+
+		struct queue
+		{
+			std::mutex mutex;
+			std::deque<task> tasks;
+		};
+
+		// Called on each worker thread, with the index of the worker, before
+		// it runs any tasks.
+		using thread_init = void (*)(void *context, size_t index);
+
+		// One queue per worker thread, and a last one that's shared by the
+		// threads that aren't workers of this pool.
+		std::unique_ptr<queue[]> _queues;
+		lak::vector<std::thread> _threads;
+		// Set before any thread starts, _threads may still be growing while
+		// the first workers run.
+		size_t _concurrency = 1;
+		thread_init _init   = nullptr;
+		void *_init_context = nullptr;
+
+		std::mutex _sleep_mutex;
+		std::condition_variable _wake;
+		std::atomic<size_t> _queued = 0;
+		bool _stopping              = false;
+
+		// Runs batches on threads - 1 worker threads and the thread that starts
+		// each batch. 0 uses std::thread::hardware_concurrency().
+		explicit worker_pool(size_t threads = 0,
+		                     thread_init init = nullptr,
+		                     void *init_context = nullptr);
+		~worker_pool();
+
+		// The concurrency of a pool made with threads, which has one fewer
+		// worker threads.
+		static size_t thread_count(size_t threads);
+
+		worker_pool(const worker_pool &)            = delete;
+		worker_pool &operator=(const worker_pool &) = delete;
+
+		// The number of threads that can run a batch at once, including the
+		// thread that started it.
+		size_t concurrency() const { return _concurrency; }
+
+		// Calls f(begin, end) for consecutive ranges of at most grain indices
+		// that together cover [0, count), and returns once every call has
+		// returned. If any call throws, the first exception is rethrown once
+		// the rest have finished.
+		template<typename F>
+		void parallel_for(size_t count, size_t grain, F &&f)
+		{
+			if (count == 0) return;
+			batch b;
+			b.context = const_cast<void *>(static_cast<const void *>(&f));
+			b.call    = [](void *context, size_t begin, size_t end)
+			{ (*static_cast<std::remove_reference_t<F> *>(context))(begin, end); };
+			run(b, count, grain == 0 ? 1 : grain);
+		}
+
+		void run(batch &b, size_t count, size_t grain);
+
+		// Runs a task from queue index, or stolen from another queue. Returns
+		// false if every queue was empty.
+		bool run_one(size_t index);
+
+		void work(size_t index);
+	};
+
+	// Use pool for the parallel builtins on this thread, nullptr selects the
+	// process wide pool (the default). Returns the previous pool.
+	lisk::worker_pool *set_worker_pool(lisk::worker_pool *pool);
+
+	// The pool that the parallel builtins on this thread use.
+	lisk::worker_pool &get_worker_pool();
+}
+
+#endif
@@ -0,0 +1,402 @@
+#include "lisk/allocator.hpp"
+
+#include "lisk/collector.hpp"
+
+#include <bit>
+
+namespace
+{
+	// Caches freed blocks in per size class free lists. Blocks are plain heap
+	// allocations, so a block cached by one thread's pool can have been
+	// allocated by another.
+	struct node_pool final : lisk::node_allocator
+	{
+		static constexpr size_t granularity = 16;
+		static constexpr size_t max_size    = 256;
+		static constexpr size_t classes     = max_size / granularity;
+		// Upper bound on the bytes cached in each size class.
+		static constexpr size_t max_cached_bytes = size_t(1) << 20;
+
+		struct free_block
+		{
+			free_block *next;
+		};
+
+		free_block *free_lists[classes] = {};
+		size_t cached_bytes[classes]    = {};
+		lisk::allocation_stats _stats;
+
+		~node_pool() { trim(); }
+
+		lisk::allocation_stats stats() const override { return _stats; }
+
+		static bool poolable(size_t size, size_t align)
+		{
+			return size <= max_size && align <= alignof(std::max_align_t);
+		}
+
+		static size_t size_class(size_t size)
+		{
+			return size == 0 ? 0 : (size - 1) / granularity;
+		}
+
+		void *allocate(size_t size, size_t align) override
+		{
+			++_stats.allocations;
+			_stats.bytes_in_use += int64_t(size);
+
+			if (!poolable(size, align))
+				return ::operator new(size, std::align_val_t(align));
+
+			const size_t c = size_class(size);
+			if (free_block *block = free_lists[c]; block)
+			{
+				free_lists[c] = block->next;
+				cached_bytes[c] -= (c + 1) * granularity;
+				_stats.bytes_cached -= (c + 1) * granularity;
+				++_stats.reused;
+				return block;
+			}
+
+			return ::operator new((c + 1) * granularity);
+		}
+
+		void deallocate(void *ptr, size_t size, size_t align) override
+		{
+			++_stats.deallocations;
+			_stats.bytes_in_use -= int64_t(size);
+
+			if (!poolable(size, align))
+			{
+				::operator delete(ptr, std::align_val_t(align));
+				return;
+			}
+
+			const size_t c     = size_class(size);
+			const size_t bytes = (c + 1) * granularity;
+			if (cached_bytes[c] + bytes > max_cached_bytes)
+			{
+				::operator delete(ptr);
+				return;
+			}
+
+			free_lists[c] = ::new (ptr) free_block{free_lists[c]};
+			cached_bytes[c] += bytes;
+			_stats.bytes_cached += bytes;
+		}
+
+		void trim()
+		{
+			for (size_t c = 0; c < classes; ++c)
+			{
+				while (free_block *block = free_lists[c])
+				{
+					free_lists[c] = block->next;
+					::operator delete(block);
+				}
+				_stats.bytes_cached -= cached_bytes[c];
+				cached_bytes[c] = 0;
+			}
+		}
+	};
+
+	thread_local lisk::node_allocator *current_allocator = nullptr;
+
+	// Nodes can outlive this thread's pool (e.g. when they're owned by another
+	// thread_local or a static), after which they go straight to the heap.
+	thread_local bool pool_destroyed = false;
+
+	struct pool_holder
+	{
+		node_pool pool;
+		~pool_holder() { pool_destroyed = true; }
+	};
+
+	node_pool *thread_pool()
+	{
+		if (pool_destroyed) return nullptr;
+		thread_local pool_holder holder;
+		return &holder.pool;
+	}
+}
+
+namespace
+{
+	using arena = lisk::arena_allocator;
+
+	constexpr size_t small_classes = arena::small_size / 16;
+	constexpr size_t large_class   = SIZE_MAX;
+
+	size_t arena_class(size_t size)
+	{
+		if (size <= arena::small_size) return size == 0 ? 0 : (size - 1) / 16;
+		// 512 is class small_classes, 1024 small_classes + 1, ...
+		return small_classes + size_t(std::countr_zero(std::bit_ceil(size))) - 9;
+	}
+
+	size_t arena_class_size(size_t c)
+	{
+		if (c < small_classes) return (c + 1) * 16;
+		return size_t(512) << (c - small_classes);
+	}
+}
+
+lisk::node_allocator::node_allocator()
+{
+	lisk::impl::register_allocator(this);
+}
+
+lisk::node_allocator::~node_allocator()
+{
+	lisk::impl::unregister_allocator(this);
+}
+
+void lisk::node_list::push(lisk::node_link &link)
+{
+	std::unique_lock lock(mutex);
+	link.list       = this;
+	link.prev       = head.prev;
+	link.next       = &head;
+	head.prev->next = &link;
+	head.prev       = &link;
+	++size;
+}
+
+void lisk::node_list::remove(lisk::node_link &link)
+{
+	std::unique_lock lock(mutex);
+	link.prev->next = link.next;
+	link.next->prev = link.prev;
+	link.prev = link.next = nullptr;
+	link.list             = nullptr;
+	--size;
+}
+
+void lisk::node_list::clear()
+{
+	std::unique_lock lock(mutex);
+	head.prev = head.next = &head;
+	size                  = 0;
+}
+
+lisk::arena_allocator::arena_allocator(size_t limit) : _limit(limit) {}
+
+lisk::arena_allocator::arena_allocator(arena_allocator &shared)
+: _limit(shared._limit), _limit_owner(&shared)
+{
+}
+
+lisk::arena_allocator::~arena_allocator()
+{
+	// Lambdas still in the chunks are freed without being destroyed.
+	_lambdas.clear();
+	while (_large) free_large(_large);
+	while (chunk *c = _chunks)
+	{
+		_chunks = c->next;
+		::operator delete(c);
+		release(chunk_size);
+	}
+}
+
+void lisk::arena_allocator::reserve(size_t bytes)
+{
+	if (!try_reserve(bytes))
+	{
+		// Large nodes that other threads freed give their memory back once
+		// they're taken.
+		take_remote();
+		if (!try_reserve(bytes)) throw std::bad_alloc();
+	}
+}
+
+bool lisk::arena_allocator::try_reserve(size_t bytes)
+{
+	auto &shared   = _limit_owner->_shared_reserved;
+	size_t current = shared.load(std::memory_order_relaxed);
+	do
+	{
+		if (_limit != 0 && current + bytes > _limit) return false;
+	} while (!shared.compare_exchange_weak(
+	  current, current + bytes, std::memory_order_relaxed));
+	_reserved += bytes;
+	return true;
+}
+
+void lisk::arena_allocator::release(size_t bytes)
+{
+	_limit_owner->_shared_reserved.fetch_sub(bytes, std::memory_order_relaxed);
+	_reserved -= bytes;
+}
+
+void lisk::arena_allocator::free_large(large_block *block)
+{
+	if (block->prev)
+		block->prev->next = block->next;
+	else
+		_large = block->next;
+	if (block->next) block->next->prev = block->prev;
+	release(sizeof(large_block) + block->size);
+	::operator delete(block);
+}
+
+void *lisk::arena_allocator::allocate(size_t size, size_t align)
+{
+	// Node blocks are never over aligned, but don't hand out misaligned
+	// memory if one is.
+	if (align > alignof(std::max_align_t)) throw std::bad_alloc();
+
+	if (size > large_size)
+	{
+		reserve(sizeof(large_block) + size);
+		void *mem   = ::operator new(sizeof(large_block) + size);
+		auto *block = ::new (mem) large_block{nullptr, _large, size};
+		if (_large) _large->prev = block;
+		_large = block;
+		++_stats.allocations;
+		_stats.bytes_in_use += int64_t(size);
+		return block + 1;
+	}
+
+	const size_t c     = arena_class(size);
+	const size_t bytes = arena_class_size(c);
+
+	if (!_free_lists[c] && _remote.load(std::memory_order_relaxed))
+		take_remote();
+
+	void *result;
+	if (free_block *block = _free_lists[c]; block)
+	{
+		_free_lists[c] = block->next;
+		_stats.bytes_cached -= bytes;
+		++_stats.reused;
+		result = block;
+	}
+	else
+	{
+		if (size_t(_end - _cursor) < bytes)
+		{
+			// The rest of the current chunk is abandoned, it's smaller than
+			// this node.
+			reserve(chunk_size);
+			auto *next = ::new (::operator new(chunk_size)) chunk{_chunks};
+			_chunks    = next;
+			_cursor    = reinterpret_cast<char *>(next) + alignof(std::max_align_t);
+			_end       = reinterpret_cast<char *>(next) + chunk_size;
+		}
+		result   = _cursor;
+		_cursor += bytes;
+	}
+
+	++_stats.allocations;
+	_stats.bytes_in_use += int64_t(bytes);
+	return result;
+}
+
+void lisk::arena_allocator::deallocate(void *ptr, size_t size, size_t)
+{
+	const size_t c = size > large_size ? large_class : arena_class(size);
+
+	if (lisk::get_node_allocator() != this)
+	{
+		// Another thread may be allocating from the arena.
+		auto *block = ::new (ptr) free_block{nullptr, c};
+		block->next = _remote.load(std::memory_order_relaxed);
+		while (!_remote.compare_exchange_weak(block->next,
+		                                      block,
+		                                      std::memory_order_release,
+		                                      std::memory_order_relaxed))
+			;
+		return;
+	}
+
+	++_stats.deallocations;
+	if (c == large_class)
+	{
+		_stats.bytes_in_use -= int64_t(size);
+		free_large(static_cast<large_block *>(ptr) - 1);
+		return;
+	}
+
+	const size_t bytes   = arena_class_size(c);
+	_free_lists[c]       = ::new (ptr) free_block{_free_lists[c], c};
+	_stats.bytes_in_use -= int64_t(bytes);
+	_stats.bytes_cached += bytes;
+}
+
+void lisk::arena_allocator::take_remote()
+{
+	free_block *block = _remote.exchange(nullptr, std::memory_order_acquire);
+	while (block)
+	{
+		free_block *next = block->next;
+		++_stats.deallocations;
+		if (block->size_class == large_class)
+		{
+			auto *large          = reinterpret_cast<large_block *>(block) - 1;
+			_stats.bytes_in_use -= int64_t(large->size);
+			free_large(large);
+		}
+		else
+		{
+			const size_t bytes          = arena_class_size(block->size_class);
+			block->next                 = _free_lists[block->size_class];
+			_free_lists[block->size_class] = block;
+			_stats.bytes_in_use        -= int64_t(bytes);
+			_stats.bytes_cached        += bytes;
+		}
+		block = next;
+	}
+}
+
+lisk::node_allocator *lisk::set_node_allocator(lisk::node_allocator *alloc)
+{
+	return std::exchange(current_allocator, alloc);
+}
+
+lisk::node_allocator *lisk::get_node_allocator()
+{
+	return current_allocator;
+}
+
+lisk::allocation_stats lisk::node_pool_stats()
+{
+	if (node_pool *pool = thread_pool(); pool) return pool->stats();
+	return {};
+}
+
+void lisk::trim_node_pool()
+{
+	if (node_pool *pool = thread_pool(); pool) pool->trim();
+}
+
+void *lisk::impl::allocate_node(lisk::node_allocator *alloc,
+                                size_t size,
+                                size_t align)
+{
+	if (alloc) return alloc->allocate(size, align);
+	if (node_pool *pool = thread_pool(); pool)
+		return pool->allocate(size, align);
+
+	// Must match the deallocation below.
+	if (node_pool::poolable(size, align))
+		return ::operator new(size);
+	else
+		return ::operator new(size, std::align_val_t(align));
+}
+
+void lisk::impl::deallocate_node(lisk::node_allocator *alloc,
+                                 void *ptr,
+                                 size_t size,
+                                 size_t align)
+{
+	if (alloc) return alloc->deallocate(ptr, size, align);
+	if (node_pool *pool = thread_pool(); pool)
+		return pool->deallocate(ptr, size, align);
+
+	// The pool hands out small blocks from the unaligned operator new.
+	if (node_pool::poolable(size, align))
+		::operator delete(ptr);
+	else
+		::operator delete(ptr, std::align_val_t(align));
+}
@@ -0,0 +1,700 @@
+#include "lisk/bytecode.hpp"
+
+#include "lisk/lisk.hpp"
+
+#include <mutex>
+
+namespace
+{
+	using lisk::bytecode::opcode;
+
+	// The builtin functors that the compiler knows how to inline.
+	struct special_forms
+	{
+		lisk::functor if_;
+		lisk::functor define;
+		lisk::functor begin;
+		lisk::functor lambda;
+		lisk::functor tail;
+		lisk::functor while_;
+		lisk::functor repeat;
+		lisk::functor list;
+		lisk::functor add;
+		lisk::functor sub;
+		lisk::functor mul;
+		lisk::functor div;
+		lisk::functor zero_check;
+	};
+
+	const special_forms &builtins()
+	{
+		static const special_forms forms = []
+		{
+			auto get = lisk::builtin::find_builtin;
+			special_forms result;
+			result.if_        = get("if");
+			result.define     = get("define");
+			result.begin      = get("begin");
+			result.lambda     = get("lambda");
+			result.tail       = get("tail");
+			result.while_     = get("while");
+			result.repeat     = get("repeat");
+			result.list       = get("list");
+			result.add        = get("+");
+			result.sub        = get("-");
+			result.mul        = get("*");
+			result.div        = get("/");
+			result.zero_check = get("zero?");
+			return result;
+		}();
+		return forms;
+	}
+
+	bool is_symbol(const lisk::expression &expr)
+	{
+		return expr.get_atom().map_or([](const auto &a) { return a.is_symbol(); },
+		                              false);
+	}
+
+	size_t length(const lisk::shared_list &l)
+	{
+		size_t result = 0;
+		for ([[maybe_unused]] const auto &node : l) ++result;
+		return result;
+	}
+
+	template<typename T>
+	lisk::exception argument_error(const lisk::expression &args, size_t index)
+	{
+		lisk::shared_list list;
+		args >> list;
+		return lisk::impl::argument_error(
+		  list.next(index), index, lisk::type_name(T{}));
+	}
+
+	struct compiler
+	{
+		const lisk::environment &env;
+		lisk::bytecode::chunk result;
+
+		uint32_t here() const { return uint32_t(result.code.size()); }
+
+		uint32_t constant(const lisk::expression &expr)
+		{
+			result.constants.push_back(expr);
+			return uint32_t(result.constants.size() - 1);
+		}
+
+		size_t emit(opcode op, uint32_t a = 0, uint32_t b = 0, uint32_t c = 0)
+		{
+			result.code.push_back({op, a, b, c});
+			return result.code.size() - 1;
+		}
+
+		// The builtin functor that the head of form names, or nullptr.
+		lisk::functor special(const lisk::shared_list &form) const
+		{
+			if_let_ok (const auto &a, form.value().get_atom())
+			{
+				// Resolved symbols are always lambda parameters.
+				if (a.is_resolved_symbol()) return nullptr;
+
+				if_let_ok (const auto &sym, a.get_symbol())
+				{
+					const auto *value = env.find(sym);
+					if (lisk::functor f = nullptr; value && *value >> f) return f;
+				}
+			}
+			return nullptr;
+		}
+
+		void compile(const lisk::expression &exp, bool tail_position)
+		{
+			lisk::impl::stack_guard guard;
+			if (guard.exceeded())
+			{
+				emit(opcode::push_const, constant(guard.error()));
+				return;
+			}
+
+			if (exp.is_null())
+			{
+				emit(opcode::push_const, constant(lisk::atom::nil{}));
+			}
+			else if_let_ok (const auto &a, exp.get_atom())
+			{
+				if (a.is_symbol())
+					emit(opcode::load, constant(a));
+				else
+					emit(opcode::push_const, constant(a));
+			}
+			else if_let_ok (const auto &l, exp.get_list())
+			{
+				compile_form(l, tail_position);
+			}
+			else if (exp.is_exception() || exp.is_vector() ||
+			         exp.is_hash_map())
+			{
+				emit(opcode::push_const, constant(exp));
+			}
+			else
+			{
+				emit(opcode::eval, constant(exp));
+			}
+		}
+
+		void compile_form(const lisk::shared_list &form, bool tail_position)
+		{
+			// This is the empty list.
+			if (form.value().is_null())
+			{
+				emit(opcode::push_const, constant(lisk::atom::nil{}));
+				return;
+			}
+
+			if (!is_symbol(form.value()))
+			{
+				emit(opcode::eval, constant(form));
+				return;
+			}
+
+			const auto &forms      = builtins();
+			const auto f           = special(form);
+			const auto args        = form.next();
+			const size_t arg_count = length(args);
+
+			auto arg = [&](size_t i) -> const lisk::expression &
+			{ return args.next(i).value(); };
+
+			if (f && f == forms.if_ && arg_count == 3)
+			{
+				compile(arg(0), false);
+				const size_t branch = emit(opcode::branch, 0, constant(args));
+				compile(arg(1), tail_position);
+				const size_t jump = emit(opcode::jump);
+				result.code[branch].a = here();
+				compile(arg(2), tail_position);
+				result.code[jump].a   = here();
+				result.code[branch].c = here();
+			}
+			else if (f && f == forms.define && arg_count == 2 && is_symbol(arg(0)))
+			{
+				compile(arg(1), false);
+				emit(opcode::define, constant(arg(0)));
+			}
+			else if (f && f == forms.begin && arg_count > 0)
+			{
+				for (size_t i = 0; i < arg_count; ++i)
+				{
+					const bool last = i + 1 == arg_count;
+					compile(arg(i), last && tail_position);
+					if (!last) emit(opcode::pop);
+				}
+			}
+			else if (f && f == forms.lambda)
+			{
+				emit(opcode::make_lambda, constant(args));
+			}
+			else if (f && f == forms.tail && arg_count > 0)
+			{
+				// (tail (func args...))
+				if (lisk::shared_list call;
+				    arg(0) >> call && is_symbol(call.value()) && !special(call))
+					compile_call(call, tail_position);
+				else
+					compile(arg(0), tail_position);
+			}
+			else if (f && f == forms.while_ && arg_count > 0)
+			{
+				const uint32_t start = here();
+				compile(arg(0), false);
+				emit(opcode::loop_while, start);
+			}
+			else if (f && f == forms.repeat && arg_count > 1)
+			{
+				compile(arg(0), false);
+				const size_t init    = emit(opcode::repeat_init, 0, constant(args));
+				const uint32_t start = here();
+				const size_t step    = emit(opcode::repeat_step);
+				compile(arg(1), false);
+				emit(opcode::pop);
+				emit(opcode::jump, start);
+				result.code[step].a = here();
+				result.code[init].c = here();
+			}
+			else if (f && f == forms.list)
+			{
+				for (size_t i = 0; i < arg_count; ++i) compile(arg(i), false);
+				emit(opcode::make_list, uint32_t(arg_count));
+			}
+			else if (f &&
+			         (f == forms.add || f == forms.sub || f == forms.mul ||
+			          f == forms.div) &&
+			         arg_count > 1)
+			{
+				const uint32_t args_index = constant(args);
+				compile(arg(0), false);
+				const size_t first = emit(opcode::expect_number, args_index, 0);
+				compile(arg(1), false);
+				const size_t second = emit(opcode::expect_number, args_index, 1);
+				emit(f == forms.add   ? opcode::add
+				     : f == forms.sub ? opcode::sub
+				     : f == forms.mul ? opcode::mul
+				                      : opcode::div);
+				result.code[first].c  = here();
+				result.code[second].c = here();
+			}
+			else if (f && f == forms.zero_check && arg_count > 0)
+			{
+				compile(arg(0), false);
+				const size_t check =
+				  emit(opcode::expect_number, constant(args), 0);
+				emit(opcode::zero_check);
+				result.code[check].c = here();
+			}
+			else
+			{
+				compile_call(form, tail_position);
+			}
+		}
+
+		void compile_call(const lisk::shared_list &form, bool tail)
+		{
+			const auto args        = form.next();
+			const size_t arg_count = length(args);
+
+			const size_t call =
+			  emit(opcode::call, constant(form), 0, uint32_t(arg_count));
+			for (const auto &node : args) compile(node.value, false);
+			emit(tail ? opcode::tail_apply : opcode::apply,
+			     result.code[call].a,
+			     0,
+			     uint32_t(arg_count));
+			result.code[call].b = here();
+		}
+	};
+
+	struct frame
+	{
+		lak::shared_ptr<const lisk::bytecode::chunk> owner;
+		const lisk::bytecode::chunk *code;
+		size_t pc;
+		lisk::environment env;
+		size_t stack_base;
+		// Approximate memory owned by this frame and its environment frame.
+		size_t memory;
+	};
+
+	// The value and frame stacks of a run. Each thread keeps one set, so that
+	// running a short chunk over and over doesn't allocate them every time. A
+	// run started while another one on the same thread is still going gets
+	// stacks of its own.
+	struct run_stacks
+	{
+		lak::vector<lisk::expression> values;
+		lak::vector<frame> frames;
+		bool in_use = false;
+	};
+
+	run_stacks &thread_stacks()
+	{
+		thread_local run_stacks stacks;
+		return stacks;
+	}
+
+	struct stacks_lease
+	{
+		run_stacks own;
+		run_stacks &stacks;
+
+		stacks_lease()
+		: stacks(thread_stacks().in_use ? own : thread_stacks())
+		{
+			stacks.in_use = true;
+		}
+
+		~stacks_lease()
+		{
+			stacks.values.clear();
+			stacks.frames.clear();
+			stacks.in_use = false;
+		}
+
+		stacks_lease(const stacks_lease &)            = delete;
+		stacks_lease &operator=(const stacks_lease &) = delete;
+	};
+
+	size_t frame_memory(const lisk::lambda &l)
+	{
+		return sizeof(frame) + sizeof(lisk::environment::frame) +
+		       l.params.size() *
+		         sizeof(lak::pair<lisk::symbol, lisk::expression>);
+	}
+
+	const lisk::lambda *get_lambda(const lisk::expression &expr)
+	{
+		if_let_ok (const auto &c, expr.get_callable())
+			if_let_ok (const auto &l, c.get_lambda())
+				return &l;
+		return nullptr;
+	}
+
+	lak::shared_ptr<const lisk::bytecode::chunk> compiled(const lisk::lambda &l)
+	{
+		// Lambdas in a frozen environment can be applied by several threads at
+		// once, only the first application of each takes the lock.
+		if (!l.compiled_code.load(std::memory_order_acquire))
+		{
+			static std::mutex mutex;
+			std::lock_guard lock(mutex);
+			if (!l.compiled_code.load(std::memory_order_relaxed))
+			{
+				l.compiled = lak::shared_ptr<const lisk::bytecode::chunk>(
+				  lak::shared_ptr<lisk::bytecode::chunk>::make(
+				    lisk::bytecode::compile(l.exp, l.captured_env)));
+				l.compiled_code.store(l.compiled.get(), std::memory_order_release);
+			}
+		}
+		return l.compiled;
+	}
+}
+
+lisk::bytecode::chunk lisk::bytecode::compile(const lisk::expression &exp,
+                                              const lisk::environment &env)
+{
+	compiler c{env, {}};
+	c.compile(exp, true);
+	c.emit(opcode::ret);
+	return lak::move(c.result);
+}
+
+lisk::expression lisk::bytecode::run(const lisk::bytecode::chunk &c,
+                                     lisk::environment &env,
+                                     bool allow_tail_eval,
+                                     size_t memory_budget)
+{
+	stacks_lease lease;
+	auto &stack  = lease.stacks.values;
+	auto &frames = lease.stacks.frames;
+	frames.push_back({{}, &c, 0, {}, 0, 0});
+
+	// Memory used by the frames on the frame stack.
+	size_t memory_used = 0;
+
+	auto pop = [&]
+	{
+		lisk::expression result = lak::move(stack.back());
+		stack.pop_back();
+		return result;
+	};
+
+	auto arithmetic = [&](auto &&op, const char *error)
+	{
+		lisk::number a, b;
+		stack[stack.size() - 2] >> a;
+		stack.back() >> b;
+		stack.pop_back();
+		if (const auto err = op(a, b, a); err != lisk::arithmetic_error::none)
+			stack.back() = lisk::arithmetic_exception(error, err);
+		else
+			stack.back() = lisk::atom{a};
+	};
+
+	for (;;)
+	{
+		frame &f = frames.back();
+		// The outermost frame runs in the caller's environment, so that
+		// defines are seen by the caller.
+		lisk::environment &e           = frames.size() == 1 ? env : f.env;
+		const lisk::bytecode::chunk &k = *f.code;
+		const auto &ins                = k.code[f.pc++];
+
+		switch (ins.op)
+		{
+			case opcode::push_const:
+				stack.push_back(k.constants[ins.a]);
+				break;
+
+			case opcode::load:
+			{
+				const auto &a = k.constants[ins.a].get_atom().unsafe_unwrap();
+				if_let_ok (const auto &sym, a.get_resolved_symbol())
+					stack.push_back(e[sym]);
+				else
+					stack.push_back(e[a.get_symbol().unsafe_unwrap()]);
+			}
+			break;
+
+			case opcode::pop:
+				stack.pop_back();
+				break;
+
+			case opcode::define:
+			{
+				lisk::symbol sym;
+				k.constants[ins.a] >> sym;
+				e.define_expr(sym, stack.back());
+				stack.back() = lisk::atom::nil{};
+			}
+			break;
+
+			case opcode::jump:
+				f.pc = ins.a;
+				break;
+
+			case opcode::branch:
+			{
+				bool b;
+				if (pop() >> b)
+				{
+					if (!b) f.pc = ins.a;
+				}
+				else
+				{
+					stack.push_back(argument_error<bool>(k.constants[ins.b], 0));
+					f.pc = ins.c;
+				}
+			}
+			break;
+
+			case opcode::loop_while:
+				if (!lisk::is_nil(pop()))
+				{
+					if (!lisk::impl::take_step()) return lisk::impl::steps_exceeded();
+					f.pc = ins.a;
+				}
+				else
+					stack.push_back(lisk::atom::nil{});
+				break;
+
+			case opcode::repeat_init:
+			{
+				lisk::uint_t count;
+				if (stack.back() >> count)
+				{
+					stack.back() = lisk::atom{lisk::number{count}};
+				}
+				else
+				{
+					stack.back() = argument_error<lisk::uint_t>(k.constants[ins.b], 0);
+					f.pc         = ins.c;
+				}
+			}
+			break;
+
+			case opcode::repeat_step:
+			{
+				lisk::uint_t count = 0;
+				stack.back() >> count;
+				if (count == 0)
+				{
+					stack.back() = lisk::atom::nil{};
+					f.pc         = ins.a;
+				}
+				else if (!lisk::impl::take_step())
+					return lisk::impl::steps_exceeded();
+				else
+					stack.back() = lisk::atom{lisk::number{count - 1}};
+			}
+			break;
+
+			case opcode::expect_number:
+				if (lisk::number n; !(stack.back() >> n))
+				{
+					stack.resize(stack.size() - (ins.b + 1));
+					stack.push_back(
+					  argument_error<lisk::number>(k.constants[ins.a], ins.b));
+					f.pc = ins.c;
+				}
+				break;
+
+			case opcode::add:
+				arithmetic(lisk::checked_add, "Add error");
+				break;
+
+			case opcode::sub:
+				arithmetic(lisk::checked_sub, "Sub error");
+				break;
+
+			case opcode::mul:
+				arithmetic(lisk::checked_mul, "Mul error");
+				break;
+
+			case opcode::div:
+				arithmetic(lisk::checked_div, "Div error");
+				break;
+
+			case opcode::zero_check:
+			{
+				lisk::number num;
+				stack.back() >> num;
+				stack.back() =
+				  lisk::atom{num.visit([](auto &&n) -> bool { return n == 0; })};
+			}
+			break;
+
+			case opcode::make_list:
+			{
+				// Same shape as lisk::eval_all.
+				auto result = lisk::shared_list::create();
+				auto end    = result;
+				for (size_t i = stack.size() - ins.a; i < stack.size(); ++i)
+				{
+					end.set_next(lisk::shared_list::create());
+					++end;
+					end.value() = lak::move(stack[i]);
+				}
+				stack.resize(stack.size() - ins.a);
+				stack.push_back(++result);
+			}
+			break;
+
+			case opcode::make_lambda:
+			{
+				lisk::shared_list l;
+				k.constants[ins.a] >> l;
+				stack.push_back(lisk::callable(lisk::lambda(l, e, allow_tail_eval)));
+			}
+			break;
+
+			case opcode::eval:
+				stack.push_back(lisk::eval(k.constants[ins.a], e, allow_tail_eval));
+				break;
+
+			case opcode::call:
+			{
+				// Not copied, most calls are to lambdas and only look at the head.
+				const auto &form = k.constants[ins.a].get_list().unsafe_unwrap();
+
+				const auto &a = form.value().get_atom().unsafe_unwrap();
+				lisk::expression head;
+				if_let_ok (const auto &sym, a.get_resolved_symbol())
+					head = e[sym];
+				else
+					head = e[a.get_symbol().unsafe_unwrap()];
+
+				if (const auto *l = get_lambda(head);
+				    l && l->params.size() == ins.c)
+				{
+					stack.push_back(lak::move(head));
+				}
+				else
+				{
+					stack.push_back(
+					  lisk::impl::eval_call(form, head, e, allow_tail_eval));
+					f.pc = ins.b;
+				}
+			}
+			break;
+
+			case opcode::apply:
+			case opcode::tail_apply:
+			{
+				const size_t callee = stack.size() - ins.c - 1;
+				const auto &l       = *get_lambda(stack[callee]);
+
+				if (!lisk::impl::take_step()) return lisk::impl::steps_exceeded();
+
+				const bool replace = ins.op == opcode::tail_apply && frames.size() > 1;
+				const size_t memory = frame_memory(l);
+				if (memory_used - (replace ? f.memory : 0) + memory +
+				      stack.size() * sizeof(lisk::expression) >
+				    memory_budget)
+				{
+					return lisk::exception{
+					  "Evaluation exceeded the memory budget of " +
+					  std::to_string(memory_budget) + " bytes calling '" +
+					  to_string(k.constants[ins.a]) + "'"};
+				}
+
+				auto new_env = lisk::environment::extends(l.captured_env);
+				for (size_t i = 0; i < ins.c; ++i)
+					new_env.define_slot(l.params[i], lak::move(stack[callee + 1 + i]));
+
+				auto code = compiled(l);
+				stack.resize(callee);
+
+				if (replace)
+				{
+					// The current frame has nothing left to do, so reuse it.
+					memory_used -= f.memory;
+					f.owner  = lak::move(code);
+					f.code   = f.owner.get();
+					f.pc     = 0;
+					f.env    = lak::move(new_env);
+					f.memory = memory;
+				}
+				else
+				{
+					const auto *ptr = code.get();
+					frames.push_back({lak::move(code),
+					                  ptr,
+					                  0,
+					                  lak::move(new_env),
+					                  stack.size(),
+					                  memory});
+				}
+				memory_used += memory;
+			}
+			break;
+
+			case opcode::ret:
+			{
+				lisk::expression result = pop();
+				stack.resize(f.stack_base);
+				memory_used -= f.memory;
+				frames.pop_back();
+				if (frames.empty()) return result;
+				stack.push_back(lak::move(result));
+			}
+			break;
+		}
+	}
+}
+
+lisk::expression lisk::bytecode::eval(const lisk::expression &exp,
+                                      lisk::environment &env,
+                                      bool allow_tail_eval,
+                                      size_t memory_budget)
+{
+	return lisk::bytecode::run(
+	  lisk::bytecode::compile(exp, env), env, allow_tail_eval, memory_budget);
+}
+
+lisk::string lisk::bytecode::to_string(const lisk::bytecode::chunk &c)
+{
+	static const char *names[] = {
+	  "push_const",
+	  "load",
+	  "pop",
+	  "define",
+	  "jump",
+	  "branch",
+	  "loop_while",
+	  "repeat_init",
+	  "repeat_step",
+	  "expect_number",
+	  "add",
+	  "sub",
+	  "mul",
+	  "div",
+	  "zero_check",
+	  "make_list",
+	  "make_lambda",
+	  "eval",
+	  "call",
+	  "apply",
+	  "tail_apply",
+	  "ret",
+	};
+
+	lisk::string result;
+	for (size_t i = 0; i < c.code.size(); ++i)
+	{
+		const auto &ins = c.code[i];
+		result += std::to_string(i) + ": " + names[size_t(ins.op)] + " " +
+		          std::to_string(ins.a) + " " + std::to_string(ins.b) + " " +
+		          std::to_string(ins.c) + "\n";
+	}
+	return result;
+}
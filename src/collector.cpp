@@ -0,0 +1,429 @@
+#include "lisk/collector.hpp"
+
+#include "lisk/lisk.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <unordered_map>
+
+namespace
+{
+	using lambda_block = lisk::node_ptr<lisk::lambda>::block;
+	using list_block =
+	  lisk::node_ptr<lisk::basic_shared_list_node<lisk::expression>>::block;
+	using frame_block = lisk::node_ptr<
+	  lisk::basic_shared_list_node<lisk::environment::frame>>::block;
+	using vector_data_block   = lisk::node_ptr<lisk::vector_data>::block;
+	using vector_branch_block = lisk::node_ptr<lisk::vector_branch>::block;
+	using vector_leaf_block   = lisk::node_ptr<lisk::vector_leaf>::block;
+	using hash_map_block      = lisk::node_ptr<lisk::hash_map_node>::block;
+
+	// Every list of lambdas, only locked when an allocator or thread comes or
+	// goes and by collect_cycles.
+	struct lambda_registry
+	{
+		std::mutex mutex;
+		lak::vector<lisk::node_allocator *> allocators;
+		// The lists of lambdas from the thread node pools. A lambda can outlive
+		// the thread that made it, so lists are never freed. The list of a
+		// thread that exited is handed to the next thread that needs one.
+		lak::vector<lisk::node_list *> thread_lists;
+		lak::vector<lisk::node_list *> free_thread_lists;
+		lisk::collector_stats stats;
+	};
+
+	lambda_registry &registry()
+	{
+		// Leaked so that lambdas destroyed during static destruction can still
+		// untrack themselves.
+		static lambda_registry *result = new lambda_registry();
+		return *result;
+	}
+
+	// Left set after the thread's holder is destroyed, lambdas made while the
+	// thread exits go on the list it gave back.
+	thread_local lisk::node_list *current_thread_list = nullptr;
+
+	struct thread_list_holder
+	{
+		thread_list_holder()
+		{
+			auto &reg = registry();
+			std::unique_lock lock(reg.mutex);
+			if (reg.free_thread_lists.empty())
+			{
+				current_thread_list = new lisk::node_list();
+				reg.thread_lists.push_back(current_thread_list);
+			}
+			else
+			{
+				current_thread_list = reg.free_thread_lists.back();
+				reg.free_thread_lists.pop_back();
+			}
+		}
+
+		~thread_list_holder()
+		{
+			auto &reg = registry();
+			std::unique_lock lock(reg.mutex);
+			reg.free_thread_lists.push_back(current_thread_list);
+		}
+	};
+
+	lisk::node_list &lambda_list(lisk::node_allocator *alloc)
+	{
+		if (alloc) return alloc->_lambdas;
+		if (!current_thread_list)
+		{
+			thread_local thread_list_holder holder;
+		}
+		return *current_thread_list;
+	}
+
+	lambda_block *block_of(lisk::node_link *link)
+	{
+		// The link is the first member of the block's header.
+		return static_cast<lambda_block *>(
+		  reinterpret_cast<lisk::node_header<lisk::lambda> *>(link));
+	}
+
+	// Call f with every lambda on every list, reg.mutex must be held.
+	template<typename F>
+	void for_each_lambda(lambda_registry &reg, F &&f)
+	{
+		auto walk = [&](lisk::node_list &list)
+		{
+			std::unique_lock lock(list.mutex);
+			for (auto *link = list.head.next; link != &list.head; link = link->next)
+				f(block_of(link));
+		};
+		for (auto *alloc : reg.allocators) walk(alloc->_lambdas);
+		for (auto *list : reg.thread_lists) walk(*list);
+	}
+
+	size_t tracked_lambdas(lambda_registry &reg)
+	{
+		size_t result = 0;
+		auto count    = [&](lisk::node_list &list)
+		{
+			std::unique_lock lock(list.mutex);
+			result += list.size;
+		};
+		for (auto *alloc : reg.allocators) count(alloc->_lambdas);
+		for (auto *list : reg.thread_lists) count(*list);
+		return result;
+	}
+
+	// reg.mutex must be held.
+	int64_t heap_bytes(lambda_registry &reg)
+	{
+		int64_t result = 0;
+		for (auto *alloc : reg.allocators) result += alloc->stats().bytes_in_use;
+		return result;
+	}
+
+	enum struct kind : uint8_t
+	{
+		lambda,
+		list,
+		frame,
+		vector_data,
+		vector_branch,
+		vector_leaf,
+		hash_map,
+	};
+
+	struct object
+	{
+		kind type;
+		// References to this object from other scanned objects.
+		size_t internal = 0;
+		bool live       = false;
+	};
+
+	size_t use_count(const void *block, kind type)
+	{
+		switch (type)
+		{
+			case kind::lambda:
+				return static_cast<const lambda_block *>(block)->count.load();
+			case kind::list:
+				return static_cast<const list_block *>(block)->count.load();
+			case kind::frame:
+				return static_cast<const frame_block *>(block)->count.load();
+			case kind::vector_data:
+				return static_cast<const vector_data_block *>(block)->count.load();
+			case kind::vector_branch:
+				return static_cast<const vector_branch_block *>(block)->count.load();
+			case kind::vector_leaf:
+				return static_cast<const vector_leaf_block *>(block)->count.load();
+			case kind::hash_map:
+				return static_cast<const hash_map_block *>(block)->count.load();
+		}
+		return 0;
+	}
+
+	template<typename F>
+	void for_each_child(const lisk::shared_list &l, F &f)
+	{
+		if (l._node) f(l._node._block, kind::list);
+	}
+
+	template<typename F>
+	void for_each_child(const lisk::environment &e, F &f)
+	{
+		if (e._map._node) f(e._map._node._block, kind::frame);
+	}
+
+	template<typename F>
+	void for_each_child(const lisk::expression &e, F &f)
+	{
+		if_let_ok (const auto &l, e.get_list())
+			for_each_child(l, f);
+		else if_let_ok (const auto &el, e.get_eval_list())
+			for_each_child(el.list, f);
+		else if_let_ok (const auto &c, e.get_callable())
+		{
+			if_let_ok (const auto &p, lak::get<lisk::callable::lambda_ptr>(c._value))
+				if (p) f(p._block, kind::lambda);
+		}
+		else if_let_ok (const auto &v, e.get_vector())
+		{
+			if (v._data) f(v._data._block, kind::vector_data);
+		}
+		else if_let_ok (const auto &m, e.get_hash_map())
+		{
+			if (m._root) f(m._root._block, kind::hash_map);
+		}
+	}
+
+	template<typename F>
+	void for_each_child(const void *block, kind type, F &f)
+	{
+		switch (type)
+		{
+			case kind::lambda:
+			{
+				const auto &l = static_cast<const lambda_block *>(block)->value;
+				for_each_child(l.exp, f);
+				for_each_child(l.captured_env, f);
+			}
+			break;
+
+			case kind::list:
+			{
+				const auto &node = static_cast<const list_block *>(block)->value;
+				if (node.next) f(node.next._block, kind::list);
+				for_each_child(node.value, f);
+			}
+			break;
+
+			case kind::frame:
+			{
+				const auto &node = static_cast<const frame_block *>(block)->value;
+				if (node.next) f(node.next._block, kind::frame);
+				for (const auto &[sym, value] : node.value.slots)
+					for_each_child(value, f);
+				for (const auto &[sym, value] : node.value.map)
+					for_each_child(value, f);
+			}
+			break;
+
+			case kind::vector_data:
+			{
+				const auto &data = static_cast<const vector_data_block *>(block)->value;
+				if (data.root) f(data.root._block, kind::vector_branch);
+				if (data.tail) f(data.tail._block, kind::vector_leaf);
+			}
+			break;
+
+			case kind::vector_branch:
+			{
+				const auto &branch =
+				  static_cast<const vector_branch_block *>(block)->value;
+				for (const auto &leaf : branch.leaves)
+					if (leaf) f(leaf._block, kind::vector_leaf);
+				for (const auto &child : branch.branches)
+					if (child) f(child._block, kind::vector_branch);
+			}
+			break;
+
+			case kind::vector_leaf:
+			{
+				const auto &leaf = static_cast<const vector_leaf_block *>(block)->value;
+				for (const auto &value : leaf.values) for_each_child(value, f);
+			}
+			break;
+
+			case kind::hash_map:
+			{
+				const auto &node = static_cast<const hash_map_block *>(block)->value;
+				// Keys are atoms, which never hold nodes.
+				for (const auto &entry : node.entries) for_each_child(entry.value, f);
+				for (const auto &child : node.children)
+					f(child._block, kind::hash_map);
+			}
+			break;
+		}
+	}
+}
+
+void lisk::impl::track_lambda(const lisk::node_ptr<lisk::lambda> &l)
+{
+	if (!l) return;
+	lambda_list(l._block->allocator).push(l._block->link);
+}
+
+void lisk::impl::untrack_lambda(lisk::node_header<lisk::lambda> &header)
+{
+	header.link.list->remove(header.link);
+}
+
+void lisk::impl::register_allocator(lisk::node_allocator *alloc)
+{
+	auto &reg = registry();
+	std::unique_lock lock(reg.mutex);
+	reg.allocators.push_back(alloc);
+}
+
+void lisk::impl::unregister_allocator(lisk::node_allocator *alloc)
+{
+	auto &reg = registry();
+	std::unique_lock lock(reg.mutex);
+	reg.allocators.erase(
+	  std::remove(reg.allocators.begin(), reg.allocators.end(), alloc),
+	  reg.allocators.end());
+}
+
+void lisk::impl::release_lambdas(lisk::node_allocator &alloc)
+{
+	auto &list = alloc._lambdas;
+
+	lak::vector<lisk::node_ptr<lisk::lambda>> lambdas;
+	{
+		std::unique_lock lock(list.mutex);
+		lambdas.reserve(list.size);
+		for (auto *link = list.head.next; link != &list.head; link = link->next)
+		{
+			lambda_block *block = block_of(link);
+			block->count.increment();
+			lambdas.emplace_back()._block = block;
+		}
+	}
+
+	for (auto &l : lambdas)
+	{
+		l->captured_env  = {};
+		l->exp           = {};
+		l->compiled_code = nullptr;
+		l->compiled      = {};
+	}
+}
+
+lisk::collector_stats lisk::collect_cycles()
+{
+	const auto begin = std::chrono::steady_clock::now();
+	auto &reg        = registry();
+
+	lisk::collector_stats stats;
+	{
+		std::unique_lock lock(reg.mutex);
+		stats                   = reg.stats;
+		stats.heap_bytes_before = heap_bytes(reg);
+	}
+
+	std::unordered_map<const void *, object> objects;
+	lak::vector<const void *> pending;
+
+	auto add = [&](const void *block, kind type) -> object &
+	{
+		auto [it, inserted] = objects.try_emplace(block, object{type});
+		if (inserted) pending.push_back(block);
+		return it->second;
+	};
+
+	// Scan everything reachable from a lambda, counting the references between
+	// the scanned objects.
+	{
+		std::unique_lock lock(reg.mutex);
+		for_each_lambda(reg, [&](lambda_block *block) { add(block, kind::lambda); });
+	}
+
+	auto count_internal = [&](const void *block, kind type)
+	{ ++add(block, type).internal; };
+	while (!pending.empty())
+	{
+		const void *block = pending.back();
+		pending.pop_back();
+		for_each_child(block, objects.at(block).type, count_internal);
+	}
+
+	// Anything with references from outside of the scanned objects is alive,
+	// and so is everything it can reach.
+	auto mark_live = [&](const void *block, kind)
+	{
+		if (auto &obj = objects.at(block); !obj.live)
+		{
+			obj.live = true;
+			pending.push_back(block);
+		}
+	};
+	for (auto &[block, obj] : objects)
+		if (use_count(block, obj.type) > obj.internal)
+			mark_live(block, obj.type);
+	while (!pending.empty())
+	{
+		const void *block = pending.back();
+		pending.pop_back();
+		for_each_child(block, objects.at(block).type, mark_live);
+	}
+
+	// Every cycle passes through a lambda's captured environment, so clearing
+	// the dead lambdas frees everything else that's dead. Hold a reference to
+	// each of them first so they don't get freed while they're cleared.
+	lak::vector<lisk::node_ptr<lisk::lambda>> dead;
+	for (const auto &[block, obj] : objects)
+	{
+		if (obj.live || obj.type != kind::lambda) continue;
+		auto *l = const_cast<lambda_block *>(static_cast<const lambda_block *>(block));
+		l->count.increment();
+		dead.emplace_back()._block = l;
+	}
+
+	for (auto &l : dead)
+	{
+		l->captured_env  = {};
+		l->exp           = {};
+		l->compiled_code = nullptr;
+		l->compiled      = {};
+	}
+
+	const size_t freed = dead.size();
+	dead.clear();
+
+	const auto end = std::chrono::steady_clock::now();
+	const double ms =
+	  std::chrono::duration<double, std::milli>(end - begin).count();
+
+	std::unique_lock lock(reg.mutex);
+	++reg.stats.collections;
+	reg.stats.objects_scanned    = objects.size();
+	reg.stats.lambdas_freed     += freed;
+	reg.stats.last_lambdas_freed = freed;
+	reg.stats.heap_bytes_before  = stats.heap_bytes_before;
+	reg.stats.heap_bytes_after   = heap_bytes(reg);
+	reg.stats.last_collection_ms = ms;
+	reg.stats.total_collection_ms += ms;
+	reg.stats.tracked_lambdas = tracked_lambdas(reg);
+	return reg.stats;
+}
+
+lisk::collector_stats lisk::cycle_collector_stats()
+{
+	auto &reg = registry();
+	std::unique_lock lock(reg.mutex);
+	auto result            = reg.stats;
+	result.tracked_lambdas = tracked_lambdas(reg);
+	return result;
+}
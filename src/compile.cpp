@@ -0,0 +1,321 @@
+#include "lisk/compile.hpp"
+
+#include "lisk/lisk.hpp"
+
+namespace
+{
+	using node = lisk::compiled_expression::function_type;
+
+	bool is_builtin(lisk::functor f, const char *name)
+	{
+		return f && f == lisk::builtin::find_builtin(name);
+	}
+
+	size_t length(const lisk::shared_list &l)
+	{
+		size_t result = 0;
+		for ([[maybe_unused]] const auto &node : l) ++result;
+		return result;
+	}
+
+	template<typename T>
+	lisk::exception argument_error(const lisk::shared_list &args, size_t index)
+	{
+		return lisk::impl::argument_error(
+		  args.next(index), index, lisk::type_name(T{}));
+	}
+
+	node constant(const lisk::expression &expr)
+	{
+		return [expr](lisk::environment &, bool) { return expr; };
+	}
+
+	struct compiler
+	{
+		const lisk::environment &env;
+
+		node compile(const lisk::expression &exp)
+		{
+			lisk::impl::stack_guard guard;
+			if (guard.exceeded()) return constant(guard.error());
+
+			if (exp.is_null())
+			{
+				return constant(lisk::atom::nil{});
+			}
+			else if_let_ok (const auto &a, exp.get_atom())
+			{
+				if_let_ok (const auto &sym, a.get_resolved_symbol())
+					return [sym](lisk::environment &e, bool) { return e[sym]; };
+				else if_let_ok (const auto &sym, a.get_symbol())
+					return compile_symbol(sym);
+				else
+					return constant(a);
+			}
+			else if_let_ok (const auto &l, exp.get_list())
+			{
+				return compile_form(l);
+			}
+			else if (exp.is_exception() || exp.is_vector() ||
+			         exp.is_hash_map())
+			{
+				return constant(exp);
+			}
+			else
+			{
+				return [exp](lisk::environment &e, bool allow_tail)
+				{ return lisk::eval(exp, e, allow_tail); };
+			}
+		}
+
+		node compile_symbol(const lisk::symbol &sym)
+		{
+			// Definitions in the innermost frame's map are bound directly. Map
+			// entries never move, and redefining sym in this frame assigns to
+			// the same entry. Redefinitions don't go into frozen frames, so
+			// theirs aren't bound.
+			const auto &frame = env._map.value();
+			if (const auto it = frame.map.find(sym);
+			    !frame.frozen && it != frame.map.end())
+			{
+				const lisk::expression *value = &it->second;
+				return [owner = env._map, value](lisk::environment &, bool)
+				{ return *value; };
+			}
+
+			return [sym](lisk::environment &e, bool) { return e[sym]; };
+		}
+
+		lisk::functor bound_functor(const lisk::expression &head) const
+		{
+			if_let_ok (const auto &a, head.get_atom())
+			{
+				// Resolved symbols are always lambda parameters.
+				if (a.is_resolved_symbol()) return nullptr;
+
+				if_let_ok (const auto &sym, a.get_symbol())
+				{
+					const auto *value = env.find(sym);
+					if (lisk::functor f = nullptr; value && *value >> f) return f;
+				}
+			}
+			return nullptr;
+		}
+
+		template<typename OP>
+		node arithmetic(const lisk::shared_list &args, OP op, const char *error)
+		{
+			return [args,
+			        a  = compile(args.value()),
+			        b  = compile(args.next().value()),
+			        op = lak::move(op),
+			        error](lisk::environment &e, bool allow_tail) -> lisk::expression
+			{
+				lisk::number x, y;
+				if (!(a(e, allow_tail) >> x))
+					return argument_error<lisk::number>(args, 0);
+				if (!(b(e, allow_tail) >> y))
+					return argument_error<lisk::number>(args, 1);
+				if (const auto err = op(x, y, x); err != lisk::arithmetic_error::none)
+					return lisk::arithmetic_exception(error, err);
+				return lisk::atom{x};
+			};
+		}
+
+		node compile_wrapped_call(const lisk::shared_list &form,
+		                          lisk::functor f,
+		                          const lisk::impl::functor_signature &signature)
+		{
+			const auto args = form.next();
+
+			lak::vector<node> evaluated;
+			auto it = args;
+			for (size_t i = 0; i < signature.arity; ++i, ++it)
+			{
+				if (signature.arguments[i] == lisk::impl::argument_kind::unevaluated)
+					evaluated.emplace_back();
+				else
+					evaluated.push_back(compile(it.value()));
+			}
+
+			return [form,
+			        f,
+			        head = compile(form.value()),
+			        call = signature.bind(args, evaluated)](lisk::environment &e,
+			                                                bool allow_tail)
+			{
+				auto callee = head(e, allow_tail);
+				if (lisk::functor g = nullptr; callee >> g && g == f)
+					return call(e, allow_tail);
+				return lisk::impl::eval_call(form, callee, e, allow_tail);
+			};
+		}
+
+		node compile_form(const lisk::shared_list &form)
+		{
+			// This is the empty list.
+			if (form.value().is_null()) return constant(lisk::atom::nil{});
+
+			if (!form.value().get_atom().map_or(
+			      [](const auto &a) { return a.is_symbol(); }, false))
+			{
+				return [form](lisk::environment &e, bool allow_tail)
+				{ return lisk::eval(form, e, allow_tail); };
+			}
+
+			const auto f           = bound_functor(form.value());
+			const auto args        = form.next();
+			const size_t arg_count = length(args);
+
+			auto arg = [&](size_t i) -> const lisk::expression &
+			{ return args.next(i).value(); };
+
+			if (is_builtin(f, "if") && arg_count == 3)
+			{
+				return [args,
+				        cond = compile(arg(0)),
+				        then = compile(arg(1)),
+				        alt  = compile(arg(2))](lisk::environment &e,
+				                               bool allow_tail) -> lisk::expression
+				{
+					bool b;
+					if (!(cond(e, allow_tail) >> b))
+						return argument_error<bool>(args, 0);
+					return b ? then(e, allow_tail) : alt(e, allow_tail);
+				};
+			}
+			else if (lisk::symbol sym;
+			         is_builtin(f, "define") && arg_count == 2 && arg(0) >> sym)
+			{
+				return [sym, value = compile(arg(1))](lisk::environment &e,
+				                                     bool allow_tail)
+				{
+					e.define_expr(sym, value(e, allow_tail));
+					return lisk::expression{lisk::atom::nil{}};
+				};
+			}
+			else if (is_builtin(f, "begin") && arg_count > 0)
+			{
+				lak::vector<node> body;
+				for (const auto &node : args) body.push_back(compile(node.value));
+				return [body = lak::move(body)](lisk::environment &e, bool allow_tail)
+				{
+					for (size_t i = 0; i + 1 < body.size(); ++i) body[i](e, allow_tail);
+					return body.back()(e, allow_tail);
+				};
+			}
+			else if (is_builtin(f, "lambda"))
+			{
+				return [args](lisk::environment &e, bool allow_tail)
+				{
+					return lisk::expression{
+					  lisk::callable(lisk::lambda(args, e, allow_tail))};
+				};
+			}
+			else if (is_builtin(f, "while") && arg_count > 0)
+			{
+				return [body = compile(arg(0))](lisk::environment &e, bool allow_tail)
+				{
+					while (!lisk::is_nil(body(e, allow_tail)))
+						if (!lisk::impl::take_step())
+							return lisk::expression{lisk::impl::steps_exceeded()};
+					return lisk::expression{lisk::atom::nil{}};
+				};
+			}
+			else if (is_builtin(f, "repeat") && arg_count > 1)
+			{
+				return [args, count = compile(arg(0)), body = compile(arg(1))](
+				         lisk::environment &e, bool allow_tail) -> lisk::expression
+				{
+					lisk::uint_t n;
+					if (!(count(e, allow_tail) >> n))
+						return argument_error<lisk::uint_t>(args, 0);
+					while (n-- > 0)
+					{
+						if (!lisk::impl::take_step()) return lisk::impl::steps_exceeded();
+						body(e, allow_tail);
+					}
+					return lisk::atom::nil{};
+				};
+			}
+			else if (is_builtin(f, "list"))
+			{
+				lak::vector<node> elements;
+				for (const auto &node : args) elements.push_back(compile(node.value));
+				return [elements = lak::move(elements)](lisk::environment &e,
+				                                        bool allow_tail)
+				{
+					// Same shape as lisk::eval_all.
+					auto result = lisk::shared_list::create();
+					auto end    = result;
+					for (const auto &element : elements)
+					{
+						end.set_next(lisk::shared_list::create());
+						++end;
+						end.value() = element(e, allow_tail);
+					}
+					return lisk::expression{++result};
+				};
+			}
+			else if (is_builtin(f, "+") && arg_count > 1)
+			{
+				return arithmetic(args, lisk::checked_add, "Add error");
+			}
+			else if (is_builtin(f, "-") && arg_count > 1)
+			{
+				return arithmetic(args, lisk::checked_sub, "Sub error");
+			}
+			else if (is_builtin(f, "*") && arg_count > 1)
+			{
+				return arithmetic(args, lisk::checked_mul, "Mul error");
+			}
+			else if (is_builtin(f, "/") && arg_count > 1)
+			{
+				return arithmetic(args, lisk::checked_div, "Div error");
+			}
+			else if (is_builtin(f, "zero?") && arg_count > 0)
+			{
+				return [args, num = compile(arg(0))](
+				         lisk::environment &e, bool allow_tail) -> lisk::expression
+				{
+					lisk::number n;
+					if (!(num(e, allow_tail) >> n))
+						return argument_error<lisk::number>(args, 0);
+					return lisk::atom{n.visit([](auto &&n) -> bool { return n == 0; })};
+				};
+			}
+			else if (const auto *signature =
+			           f ? lisk::impl::find_functor_signature(f) : nullptr;
+			         signature && arg_count >= signature->arity)
+			{
+				return compile_wrapped_call(form, f, *signature);
+			}
+			else
+			{
+				// Functors get the unevaluated arguments as usual, the head is the
+				// only part of the call that can be bound ahead of time.
+				return [form, head = compile(form.value())](lisk::environment &e,
+				                                            bool allow_tail)
+				{
+					return lisk::impl::eval_call(
+					  form, head(e, allow_tail), e, allow_tail);
+				};
+			}
+		}
+	};
+}
+
+lisk::expression lisk::compiled_expression::operator()(
+  lisk::environment &env, bool allow_tail_eval) const
+{
+	if (!_function) return lisk::expression::null{};
+	return _function(env, allow_tail_eval);
+}
+
+lisk::compiled_expression lisk::compile(const lisk::expression &exp,
+                                        const lisk::environment &env)
+{
+	lisk::compiled_expression result;
+	result._function = compiler{env}.compile(exp);
+	return result;
+}
@@ -2,6 +2,77 @@
 
 #include "lisk/shared_list.hpp"
 
+bool lisk::environment::frame::empty() const
+{
+	return slots.empty() && map.empty();
+}
+
+bool lisk::environment::frame::owns_nodes() const
+{
+	for (const auto &[sym, value] : slots)
+		if (value.owns_nodes()) return true;
+	for (const auto &[sym, value] : map)
+		if (value.owns_nodes()) return true;
+	return false;
+}
+
+lisk::expression *lisk::environment::frame::find(const lisk::symbol &sym)
+{
+	for (auto &[key, value] : slots)
+		if (key == sym) return &value;
+
+	if (map.empty()) return nullptr;
+
+	if (const auto it = map.find(sym); it != map.end()) return &it->second;
+
+	return nullptr;
+}
+
+const lisk::expression *lisk::environment::frame::find(
+  const lisk::symbol &sym) const
+{
+	return const_cast<frame *>(this)->find(sym);
+}
+
+lisk::expression &lisk::environment::frame::operator[](const lisk::symbol &sym)
+{
+	for (auto &[key, value] : slots)
+		if (key == sym) return value;
+
+	return map[sym];
+}
+
+void lisk::environment::frame::merge(frame &other)
+{
+	for (auto &[key, value] : other.slots)
+		if (!find(key)) map.emplace(key, lak::move(value));
+	other.slots.clear();
+
+	for (auto it = other.map.begin(); it != other.map.end();)
+	{
+		if (!find(it->first))
+		{
+			map.emplace(it->first, lak::move(it->second));
+			it = other.map.erase(it);
+		}
+		else
+			++it;
+	}
+}
+
+lisk::environment::environment(const lisk::environment &other)
+: _map(other._map)
+{
+	if (_map && _map.value().frozen) _map = value_type::extends(_map);
+}
+
+lisk::environment &lisk::environment::operator=(const lisk::environment &other)
+{
+	_map = other._map;
+	if (_map && _map.value().frozen) _map = value_type::extends(_map);
+	return *this;
+}
+
 lisk::environment lisk::environment::extends(const lisk::environment &other)
 {
 	lisk::environment result;
@@ -9,28 +80,66 @@ lisk::environment lisk::environment::extends(const lisk::environment &other)
 	return result;
 }
 
+lisk::environment lisk::environment::extends_loop(
+  const lisk::environment &other, const lisk::symbol &sym)
+{
+	lisk::environment result = extends(other);
+	auto &frame              = result._map.value();
+	frame.loop               = true;
+	frame.slots.emplace_back(sym, lisk::atom::nil{});
+	return result;
+}
+
+lisk::environment::frame &lisk::environment::defining_frame(
+  const lisk::symbol &sym)
+{
+	for (auto &node : _map)
+	{
+		auto &frame = node.value;
+		// Definitions pass through loop frames, unless the frame behind is
+		// frozen.
+		if (!frame.loop || !node.next || node.next->value.frozen ||
+		    frame.find(sym))
+		{
+			if (!frame.frozen) return frame;
+			break;
+		}
+	}
+
+	// Only the frozen environment itself can get here with a frozen frame,
+	// copies have a writable one in front.
+	_map = value_type::extends(_map);
+	return _map.value();
+}
+
+lisk::environment &lisk::environment::freeze()
+{
+	for (auto &node : _map) node.value.frozen = true;
+	return *this;
+}
+
 void lisk::environment::define_expr(const lisk::symbol &sym,
                                     const lisk::expression &expr)
 {
-	_map.value()[sym] = expr;
+	defining_frame(sym)[sym] = expr;
 }
 
 void lisk::environment::define_atom(const lisk::symbol &sym,
                                     const lisk::atom &a)
 {
-	_map.value()[sym] = a;
+	defining_frame(sym)[sym] = a;
 }
 
 void lisk::environment::define_list(const lisk::symbol &sym,
                                     const lisk::shared_list &list)
 {
-	_map.value()[sym] = list;
+	defining_frame(sym)[sym] = list;
 }
 
 void lisk::environment::define_callable(const lisk::symbol &sym,
                                         const lisk::callable &c)
 {
-	_map.value()[sym] = c;
+	defining_frame(sym)[sym] = c;
 }
 
 void lisk::environment::define_functor(const lisk::symbol &sym,
@@ -39,20 +148,79 @@ void lisk::environment::define_functor(const lisk::symbol &sym,
 	define_callable(sym, f);
 }
 
+void lisk::environment::define_slot(const lisk::symbol &sym,
+                                    const lisk::expression &expr)
+{
+	_map.value().slots.emplace_back(sym, expr);
+}
+
 lisk::expression lisk::environment::operator[](const lisk::symbol &sym) const
+{
+	if (const auto *expr = find(sym); expr) return *expr;
+
+	return lisk::exception{"Environment lookup failed, couldn't find '" +
+	                       to_string(sym) + "' in '" + to_string(*this) + "'"};
+}
+
+const lisk::expression *lisk::environment::find(const lisk::symbol &sym) const
 {
 	for (const auto &node : _map)
-		if (const auto it = node.value.find(sym); it != node.value.end())
-			return it->second;
+		if (const auto *expr = node.value.find(sym); expr) return expr;
 
-	return lisk::exception{"Environment lookup failed, couldn't find '" + sym +
-	                       "' in '" + to_string(*this) + "'"};
+	return nullptr;
+}
+
+lisk::expression lisk::environment::operator[](
+  const lisk::resolved_symbol &sym) const
+{
+	uint32_t depth = 0;
+	for (const auto &node : _map)
+	{
+		const auto &frame = node.value;
+		if (depth == sym.depth)
+		{
+			if (sym.slot < frame.slots.size() &&
+			    frame.slots[sym.slot].first == sym.sym)
+				return frame.slots[sym.slot].second;
+			break;
+		}
+		// A closer frame has since defined the same name, so the resolved
+		// address no longer refers to the binding that sym would find.
+		if (frame.find(sym.sym)) break;
+		++depth;
+	}
+
+	return (*this)[sym.sym];
+}
+
+lak::result<lisk::resolved_symbol> lisk::environment::resolve(
+  const lisk::symbol &sym) const
+{
+	uint32_t depth = 0;
+	for (const auto &node : _map)
+	{
+		const auto &frame = node.value;
+		for (size_t slot = 0; slot < frame.slots.size(); ++slot)
+			if (frame.slots[slot].first == sym)
+				return lak::ok_t{
+				  lisk::resolved_symbol{sym, depth, static_cast<uint32_t>(slot)}};
+		if (frame.map.find(sym) != frame.map.end()) return lak::err_t{};
+		++depth;
+	}
+
+	return lak::err_t{};
 }
 
 lisk::environment lisk::environment::clone(size_t depth) const
 {
 	lisk::environment result;
 	result._map = _map.clone(depth);
+	size_t copied = 0;
+	for (auto &node : result._map)
+	{
+		if (depth != 0 && copied++ == depth) break;
+		node.value.frozen = false;
+	}
 	return result;
 }
 
@@ -84,8 +252,12 @@ lisk::string lisk::to_string(const lisk::environment &env)
 	lisk::string result;
 	result += "(";
 	for (const auto &node : env._map)
-		for (const auto &[key, value] : node.value)
+	{
+		for (const auto &[key, value] : node.value.slots)
 			result += "(" + to_string(key) + " " + to_string(value) + ") ";
+		for (const auto &[key, value] : node.value.map)
+			result += "(" + to_string(key) + " " + to_string(value) + ") ";
+	}
 	if (result.back() == ' ') result.pop_back();
 	result += ")";
 	return result;
@@ -5,6 +5,97 @@
 #include "lisk/functor.hpp"
 #include "lisk/lambda.hpp"
 
+#include <utility>
+
+namespace
+{
+#if defined(_WIN32)
+	// Windows threads get a 1MiB stack by default.
+	thread_local size_t stack_budget = size_t(768) << 10;
+#else
+	thread_local size_t stack_budget = size_t(6) << 20;
+#endif
+	thread_local uintptr_t stack_base = 0;
+
+	thread_local size_t step_budget                = SIZE_MAX;
+	thread_local lisk::eval_step_handler step_handler = nullptr;
+	thread_local void *step_context                   = nullptr;
+}
+
+size_t lisk::eval_stack_budget()
+{
+	return stack_budget;
+}
+
+void lisk::set_eval_stack_budget(size_t bytes)
+{
+	stack_budget = bytes;
+}
+
+size_t lisk::eval_step_budget()
+{
+	return step_budget;
+}
+
+void lisk::set_eval_step_budget(size_t steps)
+{
+	step_budget = steps;
+}
+
+lak::pair<lisk::eval_step_handler, void *> lisk::set_eval_step_handler(
+  lisk::eval_step_handler handler, void *context)
+{
+	return {std::exchange(step_handler, handler),
+	        std::exchange(step_context, context)};
+}
+
+lak::pair<lisk::eval_step_handler, void *> lisk::get_eval_step_handler()
+{
+	return {step_handler, step_context};
+}
+
+bool lisk::impl::take_step()
+{
+	if (step_budget == 0)
+	{
+		if (!step_handler) return false;
+		step_budget = step_handler(step_context);
+		if (step_budget == 0) return false;
+	}
+	--step_budget;
+	return true;
+}
+
+lisk::exception lisk::impl::steps_exceeded()
+{
+	return lisk::exception{"Evaluation ran out of steps"};
+}
+
+lisk::impl::stack_guard::stack_guard()
+: _here(reinterpret_cast<uintptr_t>(this)), _outermost(stack_base == 0)
+{
+	if (_outermost) stack_base = _here;
+}
+
+lisk::impl::stack_guard::~stack_guard()
+{
+	if (_outermost) stack_base = 0;
+}
+
+bool lisk::impl::stack_guard::exceeded() const
+{
+	const uintptr_t used =
+	  stack_base > _here ? stack_base - _here : _here - stack_base;
+	return used > stack_budget;
+}
+
+lisk::exception lisk::impl::stack_guard::error() const
+{
+	return lisk::exception{"Expression nested too deeply, exceeded the stack "
+	                       "budget of " +
+	                       std::to_string(stack_budget) + " bytes"};
+}
+
 lak::pair<lisk::shared_list, size_t> lisk::eval_all(lisk::shared_list l,
                                                     lisk::environment &e,
                                                     bool allow_tail_eval)
@@ -22,10 +113,65 @@ lak::pair<lisk::shared_list, size_t> lisk::eval_all(lisk::shared_list l,
 	return {++result, count};
 }
 
+lisk::exception lisk::impl::argument_error(const lisk::shared_list &arg,
+                                          size_t index,
+                                          const lisk::string &type_name)
+{
+	return lisk::exception{"Failed to evaluate element " + std::to_string(index) +
+	                       " '" + to_string(arg.value()) + "' of '" +
+	                       to_string(arg) + "', expected type '" + type_name +
+	                       "'"};
+}
+
+lisk::expression lisk::impl::eval_call(const lisk::shared_list &l,
+                                       const lisk::expression &subexp,
+                                       lisk::environment &e,
+                                       bool allow_tail_eval)
+{
+	// This is the empty list or nil atom.
+	if (subexp.get_list().map_or([](auto &&l) { return l.value().is_null(); },
+	                             false) ||
+	    subexp.get_atom().map_or([](auto &&a) { return a.is_nil(); }, false))
+	{
+		return lisk::atom::nil{};
+	}
+	else if_let_ok (lisk::atom a, subexp.get_atom())
+	{
+		if_let_ok (lisk::symbol sym, a.get_symbol())
+			return e[sym];
+		else
+			return a;
+	}
+	else if_let_ok (lisk::shared_list l2, subexp.get_list())
+	{
+		// :TODO: Comment on why we would ever end up here?
+		return l2;
+	}
+	else if_let_ok (lisk::callable c, subexp.get_callable())
+	{
+		return c(l.next(), e, allow_tail_eval).first;
+	}
+	else if_let_ok (lisk::exception exc, subexp.get_exception())
+	{
+		return exc;
+	}
+	else
+	{
+		return lisk::exception{"Failed to eval sub-expression '" +
+		                       to_string(l.value()) + "' of '" + to_string(l) +
+		                       "', got '" + to_string(subexp) +
+		                       "', expected a symbol, atom or callable"};
+	}
+}
+
 lisk::expression lisk::eval(const lisk::expression &exp,
                             lisk::environment &e,
                             bool allow_tail_eval)
 {
+	lisk::impl::stack_guard guard;
+	if (guard.exceeded()) return guard.error();
+	if (!lisk::impl::take_step()) return lisk::impl::steps_exceeded();
+
 	if (exp.is_null())
 	{
 		// Expr was the empty list, which evaluates to nil.
@@ -40,13 +186,15 @@ lisk::expression lisk::eval(const lisk::expression &exp,
 		for (lisk::callable c; result.get_eval_list().map_or(
 		       [&](const auto &el) { return el >> c; }, false);
 		     result = lisk::eval(c({}, e, false).first, e, false))
-			;
+			if (!lisk::impl::take_step()) return lisk::impl::steps_exceeded();
 
 		return result;
 	}
-	else if_let_ok (lisk::atom a, exp.get_atom())
+	else if_let_ok (const lisk::atom &a, exp.get_atom())
 	{
-		if_let_ok (lisk::symbol sym, a.get_symbol())
+		if_let_ok (const lisk::resolved_symbol &sym, a.get_resolved_symbol())
+			return e[sym];
+		else if_let_ok (const lisk::symbol &sym, a.get_symbol())
 			return e[sym];
 		else
 			return a;
@@ -55,42 +203,13 @@ lisk::expression lisk::eval(const lisk::expression &exp,
 	{
 		// If we're about do do a function call, this should evalutate the symbol
 		// to the relevant function pointer.
-		auto subexp = lisk::eval(l.value(), e, allow_tail_eval);
-
-		// This is the empty list or nil atom.
-		if (subexp.get_list().map_or([](auto &&l) { return l.value().is_null(); },
-		                             false) ||
-		    subexp.get_atom().map_or([](auto &&a) { return a.is_nil(); }, false))
-		{
-			return lisk::atom::nil{};
-		}
-		else if_let_ok (lisk::atom a, subexp.get_atom())
-		{
-			if_let_ok (lisk::symbol sym, a.get_symbol())
-				return e[sym];
-			else
-				return a;
-		}
-		else if_let_ok (lisk::shared_list l2, subexp.get_list())
-		{
-			// :TODO: Comment on why we would ever end up here?
-			return l2;
-		}
-		else if_let_ok (lisk::callable c, subexp.get_callable())
-		{
-			return c(l.next(), e, allow_tail_eval).first;
-		}
-		else if_let_ok (lisk::exception exc, subexp.get_exception())
-		{
-			return exc;
-		}
-		else
-		{
-			return lisk::exception{"Failed to eval sub-expression '" +
-			                       to_string(l.value()) + "' of '" + to_string(exp) +
-			                       "', got '" + to_string(subexp) +
-			                       "', expected a symbol, atom or callable"};
-		}
+		return lisk::impl::eval_call(
+		  l, lisk::eval(l.value(), e, allow_tail_eval), e, allow_tail_eval);
+	}
+	else if (exp.is_vector() || exp.is_hash_map() || exp.is_callable())
+	{
+		// These are values, their elements were evaluated when they were built.
+		return exp;
 	}
 	else if_let_ok (lisk::exception exc, exp.get_exception())
 	{
@@ -3,6 +3,43 @@
 #include "lisk/eval.hpp"
 #include "lisk/expression.hpp"
 
+#include <mutex>
+#include <unordered_map>
+
+namespace
+{
+	struct signature_registry
+	{
+		std::mutex mutex;
+		std::unordered_map<lisk::functor, lisk::impl::functor_signature>
+		  signatures;
+	};
+
+	signature_registry &signatures()
+	{
+		static signature_registry registry;
+		return registry;
+	}
+}
+
+void lisk::impl::register_functor_signature(
+  lisk::functor f, const lisk::impl::functor_signature &sig)
+{
+	auto &reg = signatures();
+	std::unique_lock lock(reg.mutex);
+	reg.signatures.emplace(f, sig);
+}
+
+const lisk::impl::functor_signature *lisk::impl::find_functor_signature(
+  lisk::functor f)
+{
+	auto &reg = signatures();
+	std::unique_lock lock(reg.mutex);
+	const auto it = reg.signatures.find(f);
+	// Entries are never removed and unordered_map never moves them.
+	return it == reg.signatures.end() ? nullptr : &it->second;
+}
+
 lisk::string lisk::to_string(lisk::functor f)
 {
 	return "<builtin " +
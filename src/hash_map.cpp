@@ -0,0 +1,364 @@
+#include "lisk/hash_map.hpp"
+
+#include "lisk/atom.hpp"
+#include "lisk/expression.hpp"
+#include "lisk/shared_list.hpp"
+
+#include <bit>
+#include <climits>
+#include <cmath>
+#include <type_traits>
+#include <utility>
+
+namespace
+{
+	constexpr size_t bits      = lisk::hash_map::bits;
+	constexpr size_t mask      = lisk::hash_map::width - 1;
+	constexpr size_t hash_bits = sizeof(size_t) * CHAR_BIT;
+
+	using node_pointer = lisk::node_ptr<lisk::hash_map_node>;
+
+	uint32_t chunk_bit(size_t hash, size_t shift)
+	{
+		return uint32_t(1) << ((hash >> shift) & mask);
+	}
+
+	// The position in a dense array of the element for bit.
+	size_t index(uint32_t bitmap, uint32_t bit)
+	{
+		return size_t(std::popcount(bitmap & (bit - 1)));
+	}
+
+	// Make node safe to modify, copying it if anything else refers to it.
+	lisk::hash_map_node &writable(node_pointer &node)
+	{
+		if (node.use_count() != 1) node = node_pointer::make(*node);
+		return *node;
+	}
+
+	bool keys_equal(const lisk::atom &a, const lisk::atom &b)
+	{
+		if (a.is_nil()) return b.is_nil();
+
+		if_let_ok (const lisk::symbol &sym, a.get_symbol())
+			return b.get_symbol().map_or(
+			  [&](const lisk::symbol &other) { return sym == other; }, false);
+
+		if_let_ok (const lisk::string &str, a.get_string())
+			return b.get_string().map_or(
+			  [&](const lisk::string &other) { return str == other; }, false);
+
+		if_let_ok (bool value, a.get_bool())
+			return b.get_bool().map_or(
+			  [&](bool other) { return value == other; }, false);
+
+		if_let_ok (const lisk::number &num, a.get_number())
+			return b.get_number().map_or(
+			  [&](const lisk::number &other)
+			  {
+				  return num.visit(
+				    [&](const auto &x)
+				    {
+					    return other.visit(
+					      [&](const auto &y)
+					      {
+						      if constexpr (std::is_same_v<decltype(x), decltype(y)>)
+							      return x == y;
+						      else
+							      return false;
+					      });
+				    });
+			  },
+			  false);
+
+		return false;
+	}
+
+	// A node holding a and b, which have different keys.
+	node_pointer merge(lisk::hash_map_entry a,
+	                   lisk::hash_map_entry b,
+	                   size_t shift)
+	{
+		auto result = node_pointer::make();
+		auto &node  = *result;
+
+		if (shift >= hash_bits)
+		{
+			node.entries.push_back(lak::move(a));
+			node.entries.push_back(lak::move(b));
+			return result;
+		}
+
+		const uint32_t a_bit = chunk_bit(a.hash, shift);
+		const uint32_t b_bit = chunk_bit(b.hash, shift);
+		if (a_bit == b_bit)
+		{
+			node.nodemap = a_bit;
+			node.children.push_back(
+			  merge(lak::move(a), lak::move(b), shift + bits));
+		}
+		else
+		{
+			node.datamap = a_bit | b_bit;
+			if (a_bit > b_bit) std::swap(a, b);
+			node.entries.push_back(lak::move(a));
+			node.entries.push_back(lak::move(b));
+		}
+		return result;
+	}
+
+	// Returns true if this added a new key.
+	bool insert(node_pointer &ptr, size_t shift, lisk::hash_map_entry entry)
+	{
+		auto &node = writable(ptr);
+
+		if (shift >= hash_bits)
+		{
+			for (auto &existing : node.entries)
+			{
+				if (keys_equal(existing.key, entry.key))
+				{
+					existing.value = lak::move(entry.value);
+					return false;
+				}
+			}
+			node.entries.push_back(lak::move(entry));
+			return true;
+		}
+
+		const uint32_t bit = chunk_bit(entry.hash, shift);
+
+		if (node.datamap & bit)
+		{
+			const size_t i  = index(node.datamap, bit);
+			auto &existing = node.entries[i];
+			if (existing.hash == entry.hash && keys_equal(existing.key, entry.key))
+			{
+				existing.value = lak::move(entry.value);
+				return false;
+			}
+
+			// Both entries move down into a new child.
+			auto child =
+			  merge(lak::move(existing), lak::move(entry), shift + bits);
+			node.entries.erase(node.entries.begin() + i);
+			node.datamap &= ~bit;
+			node.nodemap |= bit;
+			node.children.insert(
+			  node.children.begin() + index(node.nodemap, bit), lak::move(child));
+			return true;
+		}
+
+		if (node.nodemap & bit)
+			return insert(node.children[index(node.nodemap, bit)],
+			              shift + bits,
+			              lak::move(entry));
+
+		node.datamap |= bit;
+		node.entries.insert(node.entries.begin() + index(node.datamap, bit),
+		                    lak::move(entry));
+		return true;
+	}
+
+	// key must be in the trie.
+	void erase(node_pointer &ptr, size_t shift, const lisk::atom &key, size_t hash)
+	{
+		auto &node = writable(ptr);
+
+		if (shift >= hash_bits)
+		{
+			for (auto it = node.entries.begin(); it != node.entries.end(); ++it)
+			{
+				if (keys_equal(it->key, key))
+				{
+					node.entries.erase(it);
+					return;
+				}
+			}
+			return;
+		}
+
+		const uint32_t bit = chunk_bit(hash, shift);
+
+		if (node.datamap & bit)
+		{
+			node.entries.erase(node.entries.begin() + index(node.datamap, bit));
+			node.datamap &= ~bit;
+			return;
+		}
+
+		const size_t i = index(node.nodemap, bit);
+		auto &child    = node.children[i];
+		erase(child, shift + bits, key, hash);
+
+		// A child that's down to a single entry is replaced by that entry, so
+		// the trie stays as shallow as its hashes allow.
+		if (child->children.empty() && child->entries.size() == 1)
+		{
+			auto entry = lak::move(child->entries[0]);
+			node.children.erase(node.children.begin() + i);
+			node.nodemap &= ~bit;
+			node.datamap |= bit;
+			node.entries.insert(node.entries.begin() + index(node.datamap, bit),
+			                    lak::move(entry));
+		}
+	}
+}
+
+lisk::hash_map_node::~hash_map_node()
+{
+	auto *queue = lisk::impl::release_queue<lisk::expression>::get();
+	// The thread is exiting, fall back to recursive destruction.
+	if (!queue) return;
+
+	bool released = false;
+	for (auto &entry : entries)
+	{
+		if (entry.value.owns_nodes())
+		{
+			queue->values.push_back(lak::move(entry.value));
+			released = true;
+		}
+	}
+
+	if (released && !queue->releasing && !lisk::deferred_release())
+		queue->release(SIZE_MAX);
+}
+
+lak::result<size_t> lisk::hash_map::hash(const lisk::atom &key)
+{
+	// Tag each hash with the key's type so that, say, the string "a" and the
+	// symbol a don't always collide.
+	auto tagged = [](size_t tag, size_t hash) -> lak::result<size_t>
+	{ return lak::ok_t{hash ^ (tag + 0x9E3779B9U + (hash << 6) + (hash >> 2))}; };
+
+	if (key.is_nil()) return tagged(0, 0);
+
+	if_let_ok (const lisk::symbol &sym, key.get_symbol())
+		return tagged(1, std::hash<lisk::symbol>{}(sym));
+
+	if_let_ok (const lisk::string &str, key.get_string())
+		return tagged(2, std::hash<lisk::string>{}(str));
+
+	if_let_ok (bool value, key.get_bool())
+		return tagged(3, value);
+
+	if_let_ok (const lisk::number &num, key.get_number())
+	{
+		// NaN is never equal to itself, so it could never be found again.
+		if (num.is_real() && std::isnan(num.get_real().unwrap()))
+			return lak::err_t{};
+		return num.visit(
+		  [&](const auto &value)
+		  {
+			  using type = std::remove_cvref_t<decltype(value)>;
+			  return tagged(std::is_same_v<type, lisk::uint_t>   ? 4
+			                : std::is_same_v<type, lisk::sint_t> ? 5
+			                                                     : 6,
+			                std::hash<type>{}(value));
+		  });
+	}
+
+	return lak::err_t{};
+}
+
+lak::result<const lisk::expression &> lisk::hash_map::find(
+  const lisk::atom &key) const
+{
+	if (!_root) return lak::err_t{};
+
+	size_t hash;
+	if_let_ok (size_t h, lisk::hash_map::hash(key))
+		hash = h;
+	else
+		return lak::err_t{};
+
+	const lisk::hash_map_node *node = _root.get();
+	for (size_t shift = 0;; shift += bits)
+	{
+		if (shift >= hash_bits)
+		{
+			for (const auto &entry : node->entries)
+				if (keys_equal(entry.key, key))
+					return lak::result_from_pointer(&entry.value);
+			return lak::err_t{};
+		}
+
+		const uint32_t bit = chunk_bit(hash, shift);
+
+		if (node->datamap & bit)
+		{
+			const auto &entry = node->entries[index(node->datamap, bit)];
+			if (entry.hash == hash && keys_equal(entry.key, key))
+				return lak::result_from_pointer(&entry.value);
+			return lak::err_t{};
+		}
+
+		if (!(node->nodemap & bit)) return lak::err_t{};
+
+		node = node->children[index(node->nodemap, bit)].get();
+	}
+}
+
+bool lisk::hash_map::set(const lisk::atom &key, lisk::expression value)
+{
+	size_t hash;
+	if_let_ok (size_t h, lisk::hash_map::hash(key))
+		hash = h;
+	else
+		return false;
+
+	// Resolved symbols are stored as the symbol they resolve.
+	lisk::hash_map_entry entry{
+	  .key   = key.is_resolved_symbol() ? lisk::atom{key.get_symbol().unwrap()}
+	                                    : key,
+	  .value = lak::move(value),
+	  .hash  = hash,
+	};
+
+	if (!_root) _root = node_pointer::make();
+	if (insert(_root, 0, lak::move(entry))) ++_size;
+	return true;
+}
+
+bool lisk::hash_map::remove(const lisk::atom &key)
+{
+	if (!find(key).is_ok()) return false;
+
+	if (--_size == 0)
+		_root = nullptr;
+	else
+		erase(_root, 0, key, lisk::hash_map::hash(key).unwrap());
+	return true;
+}
+
+lisk::string lisk::to_string(const lisk::hash_map &m)
+{
+	lisk::string result = "{";
+	bool first          = true;
+	m.for_each(
+	  [&](const lisk::atom &key, const lisk::expression &value)
+	  {
+		  if (!first) result += ", ";
+		  first = false;
+		  result += to_string(key) + " " + to_string(value);
+	  });
+	return result + "}";
+}
+
+const lisk::string &lisk::type_name(const lisk::hash_map &)
+{
+	const static lisk::string name = "hash_map";
+	return name;
+}
+
+bool operator>>(const lisk::expression &arg, lisk::hash_map &out)
+{
+	if_let_ok (const auto &m, arg.get_hash_map())
+	{
+		out = m;
+		return true;
+	}
+	else
+		return false;
+}
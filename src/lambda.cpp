@@ -1,7 +1,200 @@
 #include "lisk/lambda.hpp"
 
+#include "lisk/lisk.hpp"
 #include "lisk/shared_list.hpp"
 
+namespace
+{
+	lisk::string params_string(const lak::vector<lisk::symbol> &params)
+	{
+		lisk::string result = "(";
+		for (size_t i = 0; i < params.size(); ++i)
+		{
+			if (i > 0) result += " ";
+			result += to_string(params[i]);
+		}
+		return result + ")";
+	}
+
+	// Rewrites the symbols in a lambda body that refer to a parameter, or to a
+	// parameter of an enclosing lambda call, into resolved_symbols. Lists are
+	// only copied up to the last element that was rewritten, the rest of the
+	// body is shared with the original.
+	struct body_resolver
+	{
+		const lak::vector<lisk::symbol> &params;
+		const lisk::environment &captured_env;
+
+		lak::result<lisk::resolved_symbol> resolve(const lisk::symbol &sym) const
+		{
+			for (size_t i = 0; i < params.size(); ++i)
+				if (params[i] == sym)
+					return lak::ok_t{
+					  lisk::resolved_symbol{sym, 0, static_cast<uint32_t>(i)}};
+
+			// captured_env is the frame just outside of the call frame.
+			if_let_ok (auto resolved, captured_env.resolve(sym))
+			{
+				++resolved.depth;
+				return lak::ok_t{resolved};
+			}
+
+			return lak::err_t{};
+		}
+
+		bool rewrite(const lisk::expression &expr, lisk::expression &out) const
+		{
+			if_let_ok (const auto &a, expr.get_atom())
+			{
+				// Already resolved symbols are left alone, their lookup falls
+				// back to the name if the address turns out to be stale.
+				if (a.is_resolved_symbol()) return false;
+
+				if_let_ok (const auto &sym, a.get_symbol())
+				{
+					if_let_ok (auto resolved, resolve(sym))
+					{
+						out = lisk::atom{resolved};
+						return true;
+					}
+				}
+			}
+			else if_let_ok (const auto &l, expr.get_list())
+			{
+				if (lisk::shared_list result; rewrite(l, result))
+				{
+					out = result;
+					return true;
+				}
+			}
+			return false;
+		}
+
+		bool rewrite(const lisk::shared_list &l, lisk::shared_list &out) const
+		{
+			static const lisk::symbol lambda_sym = "lambda";
+
+			// Nested lambdas resolve their own bodies when they are created.
+			if (lisk::symbol head; l.value() >> head && head == lambda_sym)
+				return false;
+
+			lak::vector<lisk::shared_list> nodes;
+			lak::vector<lisk::expression> values;
+			size_t changed = 0;
+			for (lisk::shared_list it = l; it._node; ++it)
+			{
+				nodes.push_back(it);
+				values.push_back(it.value());
+				if (rewrite(it.value(), values.back())) changed = nodes.size();
+			}
+
+			if (changed == 0) return false;
+
+			out                      = lisk::shared_list::create();
+			lisk::shared_list result = out;
+			for (size_t i = 0; i < changed; ++i)
+			{
+				if (i > 0)
+				{
+					result.set_next(lisk::shared_list::create());
+					++result;
+				}
+				result.value() = lak::move(values[i]);
+			}
+			result.set_next(nodes[changed - 1].next());
+
+			return true;
+		}
+	};
+
+	// The builtins that pass the evaluation of one of their arguments straight
+	// through, and so continue the tail position of a lambda body.
+	struct tail_forms_t
+	{
+		lisk::functor if_;
+		lisk::functor begin;
+		lisk::functor tail;
+	};
+
+	const tail_forms_t &tail_forms()
+	{
+		static const tail_forms_t forms{lisk::builtin::find_builtin("if"),
+		                                lisk::builtin::find_builtin("begin"),
+		                                lisk::builtin::find_builtin("tail")};
+		return forms;
+	}
+
+	size_t length(const lisk::shared_list &l)
+	{
+		size_t result = 0;
+		for ([[maybe_unused]] const auto &node : l) ++result;
+		return result;
+	}
+
+	// Evaluate the arguments in l and bind them to the parameters of f in
+	// call_env. Returns the exception on failure, otherwise null.
+	lisk::expression bind_arguments(const lisk::lambda &f,
+	                                const lisk::shared_list &l,
+	                                lisk::environment &e,
+	                                bool allow_tail_eval,
+	                                lisk::environment &call_env,
+	                                size_t &param_index)
+	{
+		const auto &params = f.params;
+		for (const auto &node : l)
+		{
+			if (param_index >= params.size())
+			{
+				if (param_index == 0)
+				{
+					return lisk::exception{
+					  "Too many arguments to call lambda, expected none"};
+				}
+				else
+				{
+					return lisk::exception{
+					  "Too many arguments to call lambda, expected params are '" +
+					  params_string(params) + "'"};
+				}
+			}
+
+			call_env.define_slot(params[param_index],
+			                     lisk::eval(node.value, e, allow_tail_eval));
+			++param_index;
+		}
+
+		if (param_index < params.size())
+		{
+			return lisk::exception{"Too few parameters in '" + to_string(l) +
+			                       "' to call lambda, expected parameters are '" +
+			                       params_string(params) + "'"};
+		}
+
+		return lisk::expression::null{};
+	}
+}
+
+lisk::lambda::lambda(const lambda &other)
+: params(other.params), exp(other.exp), captured_env(other.captured_env)
+{
+	if (auto *code = other.compiled_code.load(std::memory_order_acquire))
+	{
+		compiled = other.compiled;
+		compiled_code.store(code, std::memory_order_relaxed);
+	}
+}
+
+lisk::lambda &lisk::lambda::operator=(const lambda &other)
+{
+	params       = other.params;
+	exp          = other.exp;
+	captured_env = other.captured_env;
+	auto *code   = other.compiled_code.load(std::memory_order_acquire);
+	compiled     = code ? other.compiled : nullptr;
+	compiled_code.store(code, std::memory_order_relaxed);
+	return *this;
+}
+
 lisk::lambda::lambda(lisk::shared_list l,
                      lisk::environment &e,
                      bool allow_tail_eval)
@@ -10,17 +203,13 @@ lisk::lambda::lambda(lisk::shared_list l,
 	if (lisk::shared_list arg1, arg2;
 	    l.value() >> arg1 && l.next().value() >> arg2)
 	{
-		params = arg1.clone();
+		list_reader reader(arg1, e, allow_tail_eval);
 
-		list_reader reader(params, e, allow_tail_eval);
-
-		size_t param_index = 0;
-		for (auto &node : params)
+		while (reader)
 		{
 			if (symbol s; reader >> s)
 			{
-				node.value = s;
-				++param_index;
+				params.push_back(s);
 			}
 			else
 			{
@@ -31,7 +220,7 @@ lisk::lambda::lambda(lisk::shared_list l,
 			}
 		}
 
-		exp = arg2;
+		if (!body_resolver{params, captured_env}.rewrite(arg2, exp)) exp = arg2;
 	}
 }
 
@@ -40,57 +229,89 @@ lak::pair<lisk::expression, size_t> lisk::lambda::operator()(
 {
 	auto new_env = lisk::environment::extends(captured_env);
 
-	lisk::list_reader reader(params, e, allow_tail_eval);
-
 	size_t param_index = 0;
-	for (const auto &node : l)
+	if (auto err = bind_arguments(*this, l, e, allow_tail_eval, new_env, param_index);
+	    !err.is_null())
+		return {err, 0};
+
+	return {apply(lak::move(new_env), allow_tail_eval), param_index};
+}
+
+lisk::expression lisk::lambda::apply(lisk::environment call_env,
+                                     bool allow_tail_eval) const
+{
+	const auto &forms = tail_forms();
+
+	lisk::expression body = exp;
+	for (;;)
 	{
-		auto evaled = reader.list;
-		if (!reader)
+		if (!lisk::impl::take_step()) return lisk::impl::steps_exceeded();
+
+		lisk::shared_list l;
+		if_let_ok (const auto &list, body.get_list())
+			l = list;
+		else
+			return lisk::eval(body, call_env, allow_tail_eval);
+
+		// This is the empty list.
+		if (l.value().is_null()) return lisk::atom::nil{};
+
+		const auto head = lisk::eval(l.value(), call_env, allow_tail_eval);
+		const auto args = l.next();
+
+		lisk::callable c;
+		if (!(head >> c))
+			return lisk::impl::eval_call(l, head, call_env, allow_tail_eval);
+
+		if_let_ok (const lisk::lambda &callee, c.get_lambda())
 		{
-			if (param_index == 0)
-			{
-				return {
-				  lisk::exception{"Too many arguments to call lambda, expected none"},
-				  0};
-			}
-			else
-			{
-				return {lisk::exception{
-				          "Too many arguments to call lambda, expected params are '" +
-				          to_string(params) + "'"},
-				        0};
-			}
+			// Evaluate the arguments in the current frame, then drop it in favour
+			// of the callee's.
+			auto new_env = lisk::environment::extends(callee.captured_env);
+			size_t count = 0;
+			if (auto err =
+			      bind_arguments(callee, args, call_env, allow_tail_eval, new_env, count);
+			    !err.is_null())
+				return err;
+
+			body     = callee.exp;
+			call_env = lak::move(new_env);
+			continue;
+		}
+
+		const lisk::functor f = c.get_functor().map_or(
+		  [](const lisk::functor &f) { return f; }, lisk::functor(nullptr));
+		const size_t arg_count = length(args);
+
+		if (f && f == forms.if_ && arg_count == 3)
+		{
+			bool b;
+			if (!(lisk::eval(args.value(), call_env, allow_tail_eval) >> b))
+				return lisk::impl::argument_error(args, 0, lisk::type_name(b));
+			body = args.next(b ? 1 : 2).value();
 		}
-		else if (lisk::symbol s; reader >> s)
+		else if (f && f == forms.begin && arg_count > 0)
 		{
-			new_env.define_expr(s, lisk::eval(node.value, e, allow_tail_eval));
-			++param_index;
+			auto it = args;
+			for (size_t i = 0; i + 1 < arg_count; ++i, ++it)
+				lisk::eval(it.value(), call_env, allow_tail_eval);
+			body = it.value();
+		}
+		else if (f && f == forms.tail && arg_count > 0)
+		{
+			// (tail (func args...))
+			body = args.value();
 		}
 		else
 		{
-			return {lisk::exception{"Failed to get symbol " +
-			                        std::to_string(param_index) + " from '" +
-			                        to_string(node.value) + "' for '" +
-			                        to_string(evaled) + "'"},
-			        0};
+			return lisk::impl::eval_call(l, head, call_env, allow_tail_eval);
 		}
 	}
-
-	if (reader)
-	{
-		return {lisk::exception{"Too few parameters in '" + to_string(l) +
-		                        "' to call lambda, expected parameters are '" +
-		                        to_string(params) + "'"},
-		        0};
-	}
-
-	return {lisk::eval(exp, new_env, allow_tail_eval), param_index};
 }
 
 lisk::string lisk::to_string(const lisk::lambda &l)
 {
-	return "(lambda " + to_string(l.params) + " " + to_string(l.exp) + ")";
+	return "(lambda " + params_string(l.params) + " " + to_string(l.exp) + ")";
 }
 
 const lisk::string &type_name(const lisk::lambda &)
@@ -3,7 +3,11 @@
 #include "lak/array.hpp"
 #include "lak/span_manip.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <charconv>
 #include <iostream>
+#include <mutex>
 
 const std::regex lisk::numeric_regex(
   "(?:([\\-\\+])?(\\d+)(\\.\\d+)?)|"
@@ -42,9 +46,97 @@ bool lisk::is_bracket(const char c)
 	}
 }
 
-bool lisk::is_numeric(const lisk::string &token)
+bool lisk::is_numeric(std::string_view token)
 {
-	return std::regex_match(token, lisk::numeric_regex);
+	return lisk::scan_number(token).is_ok();
+}
+
+lak::result<lisk::number> lisk::scan_number(std::string_view token)
+{
+	const char *it        = token.data();
+	const char *const end = it + token.size();
+
+	char sign = 0;
+	if (it != end && (*it == '-' || *it == '+')) sign = *it++;
+
+	int base = 10;
+	if (end - it > 2 && it[0] == '0')
+	{
+		if (it[1] == 'x' || it[1] == 'X')
+			base = 16;
+		else if (it[1] == 'b' || it[1] == 'B')
+			base = 2;
+		if (base != 10) it += 2;
+	}
+
+	auto is_digit = [base](const char c) -> bool
+	{
+		switch (base)
+		{
+			case 2:
+				return c == '0' || c == '1';
+			case 16:
+				return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') ||
+				       (c >= 'A' && c <= 'F');
+			default:
+				return c >= '0' && c <= '9';
+		}
+	};
+
+	const char *const int_begin = it;
+	while (it != end && is_digit(*it)) ++it;
+	const char *const int_end = it;
+	if (int_begin == int_end) return lak::err_t{};
+
+	// Binary literals don't have a fractional part.
+	bool is_real = false;
+	if (it != end && *it == '.' && base != 2)
+	{
+		const char *const frac_begin = ++it;
+		while (it != end && is_digit(*it)) ++it;
+		if (it == frac_begin) return lak::err_t{};
+		is_real = true;
+	}
+
+	if (it != end) return lak::err_t{};
+
+	if (is_real)
+	{
+		lisk::real_t value;
+		const auto [ptr, ec] = std::from_chars(
+		  int_begin,
+		  end,
+		  value,
+		  base == 16 ? std::chars_format::hex : std::chars_format::fixed);
+		if (ec != std::errc{} || ptr != end) return lak::err_t{};
+		return lak::ok_t{lisk::number(sign == '-' ? -value : value)};
+	}
+
+	lisk::uint_t magnitude;
+	const auto [ptr, ec] = std::from_chars(int_begin, int_end, magnitude, base);
+	if (ec != std::errc{} || ptr != int_end) return lak::err_t{};
+
+	constexpr lisk::uint_t sint_max =
+	  static_cast<lisk::uint_t>(std::numeric_limits<lisk::sint_t>::max());
+
+	if (sign == 0)
+	{
+		// unsigned int
+		return lak::ok_t{lisk::number(magnitude)};
+	}
+	else if (sign == '-')
+	{
+		// signed int, the magnitude of the minimum is one more than the maximum.
+		if (magnitude > sint_max + 1U) return lak::err_t{};
+		return lak::ok_t{
+		  lisk::number(static_cast<lisk::sint_t>(lisk::uint_t(0) - magnitude))};
+	}
+	else
+	{
+		// signed int
+		if (magnitude > sint_max) return lak::err_t{};
+		return lak::ok_t{lisk::number(static_cast<lisk::sint_t>(magnitude))};
+	}
 }
 
 bool lisk::is_nil(const lisk::expression &expr)
@@ -59,91 +151,165 @@ bool lisk::is_null(const lisk::expression &expr)
 	return expr.is_null();
 }
 
-lak::vector<lisk::string> lisk::tokenise(const lisk::string &str,
-                                         size_t *chars_used)
+lisk::expression lisk::arithmetic_exception(const lisk::string &message,
+                                            lisk::arithmetic_error err)
 {
-	lak::vector<lisk::string> result;
-	lisk::string buffer;
-	size_t chars_read = 0;
+	return lisk::exception{message + ": " + to_string(err)};
+}
 
-	auto begin_next = [&]
+bool lisk::lexer::next(lisk::token &out)
+{
+	const size_t size = source.size();
+
+	// Skip whitespace and comments.
+	while (position < size)
 	{
-		if (!buffer.empty()) result.emplace_back(lak::move(buffer));
-		buffer.clear();
-		if (chars_used) *chars_used = chars_read;
-	};
+		if (source[position] == ';')
+		{
+			while (position < size && source[position] != '\n') ++position;
+		}
+		else if (lisk::is_whitespace(source[position]))
+		{
+			++position;
+		}
+		else
+			break;
+	}
+
+	if (position >= size) return false;
+
+	const size_t begin = position;
+
+	if (lisk::is_bracket(source[begin]))
+	{
+		out      = lisk::token{lisk::token_kind::bracket, begin, 1};
+		position = begin + 1;
+		return true;
+	}
 
 	bool in_string          = false;
 	bool is_string_escaping = false;
-	bool in_comment         = false;
+	bool has_escapes        = false;
 	char string_char        = 0;
-	for (const auto c : str)
+	for (size_t i = begin; i < size; ++i)
 	{
-		++chars_read;
-		if (in_comment)
-		{
-			if (c == '\n') in_comment = false;
-		}
-		else if (in_string)
+		const char c = source[i];
+		if (in_string)
 		{
 			if (is_string_escaping)
 			{
-				if (c == 'n')
-					buffer += '\n';
-				else if (c == 'r')
-					buffer += '\r';
-				else if (c == 't')
-					buffer += '\t';
-				else if (c == '0')
-					buffer += '\0';
-				else
-					buffer += c;
 				is_string_escaping = false;
 			}
 			else if (c == '\\')
 			{
 				is_string_escaping = true;
+				has_escapes        = true;
 			}
-			else
+			else if (c == string_char)
 			{
-				buffer += c;
-				if (c == string_char)
-				{
-					in_string = false;
-					begin_next();
-				}
+				// Strings end the token they're in.
+				const auto kind = has_escapes ? lisk::token_kind::escaped_string
+				                              : lisk::token_kind::string;
+				out             = lisk::token{kind, begin, i + 1 - begin};
+				position        = i + 1;
+				return true;
 			}
 		}
-		else if (c == ';')
+		else if (c == '"' || c == '\'')
 		{
-			in_comment = true;
+			in_string   = true;
+			string_char = c;
 		}
-		else if (c == '"' || c == '\'')
+		else if (c == ';' || lisk::is_whitespace(c) || lisk::is_bracket(c))
 		{
-			buffer += c;
-			in_string          = true;
-			is_string_escaping = false;
-			string_char        = c;
+			out      = lisk::token{lisk::token_kind::atom, begin, i - begin};
+			position = i;
+			return true;
 		}
-		else if (lisk::is_whitespace(c))
+	}
+
+	// Ran out of source before the token was terminated.
+	return false;
+}
+
+lak::vector<lisk::token> lisk::lex(std::string_view str, size_t *chars_used)
+{
+	lak::vector<lisk::token> result;
+	lisk::lexer lexer(str);
+
+	if (chars_used) *chars_used = 0;
+
+	for (lisk::token tok; lexer.next(tok);)
+	{
+		result.push_back(tok);
+		if (chars_used) *chars_used = tok.offset + tok.length;
+	}
+
+	return result;
+}
+
+lisk::string lisk::token_string(std::string_view source,
+                                const lisk::token &tok)
+{
+	const std::string_view text = tok.view(source);
+
+	if (tok.kind != lisk::token_kind::escaped_string)
+		return lisk::string{lak::astring(text)};
+
+	lisk::string result;
+	result.reserve(text.size());
+
+	bool in_string          = false;
+	bool is_string_escaping = false;
+	char string_char        = 0;
+	for (const auto c : text)
+	{
+		if (!in_string)
 		{
-			if (!buffer.empty()) begin_next();
+			result += c;
+			if (c == '"' || c == '\'')
+			{
+				in_string   = true;
+				string_char = c;
+			}
 		}
-		else if (lisk::is_bracket(c))
+		else if (is_string_escaping)
 		{
-			if (!buffer.empty()) begin_next();
-			buffer += c;
-			begin_next();
+			if (c == 'n')
+				result += '\n';
+			else if (c == 'r')
+				result += '\r';
+			else if (c == 't')
+				result += '\t';
+			else if (c == '0')
+				result += '\0';
+			else
+				result += c;
+			is_string_escaping = false;
+		}
+		else if (c == '\\')
+		{
+			is_string_escaping = true;
 		}
 		else
 		{
-			buffer += c;
+			result += c;
+			if (c == string_char) in_string = false;
 		}
 	}
 
 	return result;
 }
 
+lak::vector<lisk::string> lisk::tokenise(const lisk::string &str,
+                                         size_t *chars_used)
+{
+	lak::vector<lisk::string> result;
+	for (const auto &tok : lisk::lex(str, chars_used))
+		result.emplace_back(lisk::token_string(str, tok));
+	return result;
+}
+
 lak::vector<lisk::string> lisk::root_tokenise(const lisk::string &str,
                                               size_t *chars_used)
 {
@@ -156,222 +322,270 @@ lak::vector<lisk::string> lisk::root_tokenise(const lisk::string &str,
 	return result;
 }
 
-lisk::number lisk::parse_number(const lisk::string &token)
+lisk::number lisk::parse_number(std::string_view token)
 {
-	lisk::number result;
+	if_let_ok (lisk::number num, lisk::scan_number(token))
+		return num;
+	else
+		return std::numeric_limits<lisk::real_t>::signaling_NaN();
+}
 
-	std::smatch match;
+lisk::string lisk::parse_string(std::string_view token)
+{
+	if (token.size() == 2) return lisk::string{};
+	return lisk::string{lak::astring(token.substr(1, token.size() - 2))};
+}
 
-	if (!std::regex_match(token, match, lisk::numeric_regex) ||
-	    match.size() != 9)
-		return std::numeric_limits<real_t>::signaling_NaN();
+lisk::expression lisk::parse_atom(std::string_view token)
+{
+	if (token.front() == '"')
+		return lisk::atom{lisk::parse_string(token)};
+	else if (token == "nil")
+		return lisk::atom{lisk::atom::nil{}};
+	else if (token == "true")
+		return lisk::atom{true};
+	else if (token == "false")
+		return lisk::atom{false};
+	else if_let_ok (lisk::number num, lisk::scan_number(token))
+		return lisk::atom{num};
+	else
+		return lisk::atom{lisk::symbol(token)};
+}
 
-	if (match[2].matched)
+namespace
+{
+	// Builds nested lists one element at a time. Only the last cell of each
+	// open scope is kept, so memory use is bounded by the nesting depth rather
+	// than the number of elements.
+	struct list_builder
 	{
-		if (match[3].matched)
+		lisk::shared_list root;
+		lak::vector<lisk::shared_list> tails;
+
+		// Get the cell that the next element of the current scope should be
+		// written to.
+		lisk::shared_list push_element()
 		{
-			// floating point
-			result = std::stold(match[2].str() + match[3].str());
+			if (tails.empty()) return {};
+			lisk::shared_list &tail = tails.back();
+			// If this element holds null then no values have been added to this
+			// scope yet, so return it immediately.
+			if (!tail) return tail;
+			// Else the last element already has a value, add a new element after
+			// it.
+			auto new_element = lisk::shared_list::create();
+			tail.set_next(new_element);
+			tail = new_element;
+			return tail;
 		}
-		else if (match[1].matched)
+
+		void push_scope()
 		{
-			// signed int
-			result = static_cast<lisk::sint_t>(
-			  std::stoll(match[1].str() + match[2].str(), nullptr, 10));
+			auto scope    = lisk::shared_list::create();
+			scope.value() = lisk::expression::null{};
+
+			// If this is the first scope, make sure to mark it as the root.
+			// Else this is a nested scope, push it as a value onto the parent
+			// scope.
+			if (tails.empty())
+				root = scope;
+			else
+				push_element().value() = scope;
+
+			tails.push_back(scope);
 		}
-		else
+
+		void pop_scope()
 		{
-			// unsigned int
-			result =
-			  static_cast<lisk::uint_t>(std::stoull(match[2].str(), nullptr, 10));
+			// Ignore unbalanced closing brackets.
+			if (!tails.empty()) tails.pop_back();
 		}
-	}
-	else if (match[5].matched)
+	};
+
+	// NEXT(token) reads the next token, returning false at the end of input.
+	// BRACKET(token) returns the bracket character of a token, or 0 if the
+	// token is not a bracket. VALUE(token) parses a non-bracket token.
+	template<typename TOKEN, typename NEXT, typename BRACKET, typename VALUE>
+	lisk::expression parse_tokens(bool root,
+	                              NEXT &&next,
+	                              BRACKET &&bracket,
+	                              VALUE &&value)
 	{
-		if (match[6].matched)
-		{
-			// floating point
-			result = std::stold("0x" + match[2].str() + match[3].str());
-		}
-		else if (match[4].matched)
-		{
-			// signed int
-			result = static_cast<lisk::sint_t>(
-			  std::stoll(match[4].str() + match[5].str(), nullptr, 16));
-		}
-		else
+		static const lisk::symbol begin_sym      = "begin";
+		static const lisk::symbol list_sym       = "list";
+		static const lisk::symbol eval_stack_sym = "eval-stack";
+
+		list_builder builder;
+
+		bool started = false;
+
+		for (TOKEN token; next(token);)
 		{
-			// unsigned int
-			result =
-			  static_cast<lisk::uint_t>(std::stoull(match[5].str(), nullptr, 16));
+			if (root && !started)
+			{
+				builder.push_scope();
+				builder.push_element().value() = lisk::atom{begin_sym};
+			}
+			started = true;
+
+			const char c = bracket(token);
+			if (c == '(')
+			{
+				builder.push_scope();
+			}
+			else if (c == '[')
+			{
+				builder.push_scope();
+				builder.push_element().value() = lisk::atom{list_sym};
+			}
+			else if (c == '{')
+			{
+				builder.push_scope();
+				builder.push_element().value() = lisk::atom{eval_stack_sym};
+			}
+			else if (c == ')' || c == ']' || c == '}')
+			{
+				builder.pop_scope();
+			}
+			else
+			{
+				lisk::expression element = value(token);
+
+				if (builder.tails.empty())
+					return element;
+				else
+					builder.push_element().value() = lak::move(element);
+			}
 		}
+
+		return lisk::expression{builder.root};
 	}
-	else if (match[8].matched)
+
+	char token_bracket(std::string_view source, const lisk::token &tok)
 	{
-		if (match[7].matched)
-		{
-			// signed int
-			result = static_cast<lisk::sint_t>(
-			  std::stoll(match[7].str() + match[8].str(), nullptr, 2));
-		}
-		else
+		return tok.kind == lisk::token_kind::bracket ? source[tok.offset] : 0;
+	}
+
+	lisk::expression token_value(std::string_view source,
+	                             const lisk::token &tok)
+	{
+		switch (tok.kind)
 		{
-			// unsigned int
-			result =
-			  static_cast<lisk::uint_t>(std::stoull(match[8].str(), nullptr, 2));
+			case lisk::token_kind::escaped_string:
+				// Escape sequences need to be materialised first.
+				return lisk::parse_atom(lisk::token_string(source, tok));
+
+			default:
+				return lisk::parse_atom(tok.view(source));
 		}
 	}
-	else
-		return std::numeric_limits<lisk::real_t>::signaling_NaN();
 
-	return result;
-}
+	lisk::expression parse_source(std::string_view source, bool root)
+	{
+		lisk::lexer lexer(source);
+		return parse_tokens<lisk::token>(
+		  root,
+		  [&](lisk::token &tok) { return lexer.next(tok); },
+		  [&](const lisk::token &tok) { return token_bracket(source, tok); },
+		  [&](const lisk::token &tok) { return token_value(source, tok); });
+	}
 
-lisk::string lisk::parse_string(const lisk::string &token)
-{
-	if (token.size() == 2) return lisk::string{};
-	return lisk::string{token.substr(1, token.size() - 2)};
+	lisk::expression parse_view_tokens(std::string_view source,
+	                                   const lak::vector<lisk::token> &tokens,
+	                                   bool root)
+	{
+		size_t index = 0;
+		return parse_tokens<lisk::token>(
+		  root,
+		  [&](lisk::token &tok)
+		  {
+			  if (index >= tokens.size()) return false;
+			  tok = tokens[index++];
+			  return true;
+		  },
+		  [&](const lisk::token &tok) { return token_bracket(source, tok); },
+		  [&](const lisk::token &tok) { return token_value(source, tok); });
+	}
 }
 
 lisk::expression lisk::parse(const lak::vector<lisk::string> &tokens)
 {
-	lisk::shared_list root;
-	lak::vector<lak::vector<lisk::shared_list>> stack;
-
-	auto push_element = [&]() -> lisk::shared_list
-	{
-		if (stack.empty()) return {};
-		// Get the previous nill element.
-		lisk::shared_list old_element = stack.back().back();
-		// If this element holds null_t then no values have been added to this
-		// scope yet, so return immediately.
-		if (!old_element) return old_element;
-		// Else if the last element already has a value, add a new element after
-		// it
-		auto new_element = lisk::shared_list::create();
-		// Set the new nill element as the next element from the previous nill
-		// element.
-		old_element.set_next(new_element);
-		// Push the new nill element into the stack scope.
-		stack.back().emplace_back(new_element);
-		// Return the old nill element so a value can be added to it.
-		return new_element;
-	};
-
-	auto push_scope = [&]()
-	{
-		// Create the root element for the new stack.
-		auto scope    = lisk::shared_list::create();
-		scope.value() = lisk::expression::null{};
-
-		// If this is the first scope, make sure to mark it as the root.
-		// Else this is a nested scope, push it as a value onto the parent scope.
-		if (stack.empty())
-			root = scope;
-		else
-			push_element().value() = scope;
-
-		// Push the new scope onto the stack.
-		stack.emplace_back();
-		stack.back().emplace_back(scope);
-	};
+	size_t index = 0;
+	return parse_tokens<std::string_view>(
+	  false,
+	  [&](std::string_view &token)
+	  {
+		  if (index >= tokens.size()) return false;
+		  token = tokens[index++];
+		  return true;
+	  },
+	  [](std::string_view token) -> char
+	  { return lisk::is_bracket(token.front()) ? token.front() : 0; },
+	  [](std::string_view token) { return lisk::parse_atom(token); });
+}
 
-	auto pop_scope = [&]()
-	{
-		// Pop the scope off the stack.
-		stack.pop_back();
-	};
+lisk::expression lisk::parse(std::string_view source,
+                             const lak::vector<lisk::token> &tokens)
+{
+	return parse_view_tokens(source, tokens, false);
+}
 
-	for (const auto &token : tokens)
-	{
-		const char c = token.front();
-		if (c == '(')
-		{
-			push_scope();
-		}
-		else if (c == '[')
-		{
-			push_scope();
-			push_element().value() = lisk::atom{lisk::symbol("list")};
-		}
-		else if (c == '{')
-		{
-			push_scope();
-			push_element().value() = lisk::atom{lisk::symbol("eval-stack")};
-		}
-		else if (c == ')' || c == ']' || c == '}')
-		{
-			pop_scope();
-		}
-		else
-		{
-			expression value;
-
-			if (c == '"')
-				value = lisk::atom{lisk::parse_string(token)};
-			else if (token == "nil")
-				value = lisk::atom{lisk::atom::nil{}};
-			else if (token == "true")
-				value = lisk::atom{true};
-			else if (token == "false")
-				value = lisk::atom{false};
-			else if (is_numeric(token))
-				value = lisk::atom{lisk::parse_number(token)};
-			else
-				value = lisk::atom{lisk::symbol(token)};
+lisk::expression lisk::root_parse(std::string_view source,
+                                  const lak::vector<lisk::token> &tokens)
+{
+	return parse_view_tokens(source, tokens, true);
+}
 
-			if (stack.empty())
-				return value;
-			else
-				push_element().value() = value;
-		}
-	}
+lisk::expression lisk::parse_source(std::string_view source)
+{
+	return ::parse_source(source, false);
+}
 
-	return lisk::expression{root};
+lisk::expression lisk::root_parse_source(std::string_view source)
+{
+	return ::parse_source(source, true);
 }
 
 lisk::expression lisk::eval_string(const lisk::string &str,
                                    lisk::environment &env)
 {
-	return lisk::eval(lisk::parse(lisk::tokenise(str)), env, true);
+	return lisk::eval(lisk::parse_source(str), env, true);
 }
 
 lisk::expression lisk::root_eval_string(const lisk::string &str,
                                         lisk::environment &env)
 {
-	return lisk::eval(lisk::parse(lisk::root_tokenise(str)), env, true);
+	return lisk::eval(lisk::root_parse_source(str), env, true);
+}
+
+lisk::expression lisk::quoted(const lisk::expression &value)
+{
+	const bool self_evaluating =
+	  value.get_atom().map_or(
+	    [](const lisk::atom &a)
+	    { return !a.is_symbol() && !a.is_resolved_symbol(); },
+	    false) ||
+	  value.is_callable() || value.is_vector() || value.is_hash_map() ||
+	  value.is_exception();
+	if (self_evaluating) return value;
+
+	// The builtin itself rather than the symbol quote, which could have been
+	// redefined.
+	static const lisk::functor quote_functor = LISK_FUNCTOR_WRAPPER(
+	  lisk::builtin::quote);
+	auto result         = lisk::shared_list::create();
+	result.value()      = lisk::callable(quote_functor);
+	result.next_value() = value;
+	return result;
 }
 
 lisk::expression lisk::tail_eval(lisk::expression expr,
                                  lisk::environment &env,
                                  bool allow_tail)
 {
-	// grandp   parent   env
-	// * ------ * ------ *
-	//  `.
-	//    `.
-	//      `* ------ * tail_env (env clone)
-	//    parent (clone)
-	lisk::environment tail_env = env.clone(2);
-	// grandp   parent   env
-	// * ------ * ------ *
-	//  `.
-	//    `.
-	//      `* tail_env (squashed env->parent clone)
-	tail_env.squash(2);
-
-	auto result = lisk::shared_list::create();
-
-	// (lambda () (expr))
-	lisk::shared_list lambda_list;
-	lambda_list.value()      = lisk::shared_list::create(); // no arguments
-	lambda_list.next_value() = expr;                        // lambda body
-	result.value() =
-	  lisk::callable(lisk::lambda(lambda_list, tail_env, allow_tail));
-
-	// Return an eval_shared_list containing a lambda that immediately
-	// evaluates our expr.
-	return lisk::eval_shared_list{result};
+	// Calls in tail position of a lambda body are already turned into jumps by
+	// lisk::lambda::apply, anywhere else there is no frame to replace.
+	return lisk::eval(expr, env, allow_tail);
 }
 
 bool lisk::reader::iterator::operator==(sentinel) const
@@ -477,19 +691,21 @@ lisk::expression lisk::builtin::list_env(lisk::environment &env, bool)
 
 	lisk::shared_list previous = root;
 	lisk::shared_list l        = root;
-	for (const auto &node : env._map)
+	auto push = [&](const lisk::symbol &key, const lisk::expression &value)
 	{
-		for (const auto &[key, value] : node.value)
-		{
-			auto entry         = lisk::shared_list::create();
-			entry.value()      = lisk::atom{key};
-			entry.next_value() = value;
+		auto entry         = lisk::shared_list::create();
+		entry.value()      = lisk::atom{key};
+		entry.next_value() = value;
 
-			l.value() = entry;
-			l.set_next(lisk::shared_list::create());
+		l.value() = entry;
+		l.set_next(lisk::shared_list::create());
 
-			previous = l++;
-		}
+		previous = l++;
+	};
+	for (const auto &node : env._map)
+	{
+		for (const auto &[key, value] : node.value.slots) push(key, value);
+		for (const auto &[key, value] : node.value.map) push(key, value);
 	}
 	previous.clear_next();
 
@@ -551,6 +767,13 @@ lisk::expression lisk::builtin::evaluate(lisk::environment &env,
 	return lisk::eval(exp, env, allow_tail);
 }
 
+lisk::expression lisk::builtin::quote(lisk::environment &,
+                                      bool,
+                                      lisk::uneval_expr exp)
+{
+	return exp.expr;
+}
+
 lak::pair<lisk::expression, size_t> lisk::builtin::evaluate_stack(
   lisk::shared_list l, lisk::environment &env, bool allow_tail)
 {
@@ -595,7 +818,11 @@ lisk::expression lisk::builtin::repeat(lisk::environment &env,
                                        lisk::uint_t count,
                                        lisk::uneval_expr exp)
 {
-	while (count-- > 0) lisk::eval(exp.expr, env, allow_tail);
+	while (count-- > 0)
+	{
+		if (!lisk::impl::take_step()) return lisk::impl::steps_exceeded();
+		lisk::eval(exp.expr, env, allow_tail);
+	}
 	return lisk::atom::nil{};
 }
 
@@ -604,61 +831,452 @@ lisk::expression lisk::builtin::repeat_while(lisk::environment &env,
                                              lisk::uneval_expr exp)
 {
 	while (!lisk::is_nil(lisk::eval(exp.expr, env, allow_tail)))
-		;
+		if (!lisk::impl::take_step()) return lisk::impl::steps_exceeded();
 	return lisk::atom::nil{};
 }
 
+namespace
+{
+	// Hash map entries are iterated as [key value] vectors, which unlike lists
+	// evaluate to themselves when they're passed on as arguments.
+	lisk::vector key_value_pair(const lisk::atom &key,
+	                            const lisk::expression &value)
+	{
+		lisk::vector result;
+		result.push_back(key);
+		result.push_back(value);
+		return result;
+	}
+
+	// Calls a function with arguments that have already been evaluated.
+	// Lambdas get them bound straight into the parameter slots of a call
+	// frame, which is reused until the body captures it or defines something
+	// in it. Other callables, and lambdas that take a different number of
+	// arguments, are called the usual way with the values as their argument
+	// list, which is reused until the callable keeps part of it. Each thread
+	// needs its own direct_call.
+	struct direct_call
+	{
+		const lisk::callable &callable;
+		lisk::environment &env;
+		bool allow_tail;
+		const lisk::lambda *lambda = nullptr;
+		lisk::environment call_env;
+		lisk::shared_list args;
+
+		direct_call(const lisk::callable &c,
+		            size_t arity,
+		            lisk::environment &e,
+		            bool allow_tail_eval)
+		: callable(c), env(e), allow_tail(allow_tail_eval)
+		{
+			if_let_ok (const lisk::lambda &l, c.get_lambda())
+			{
+				if (l.params.size() == arity) lambda = &l;
+			}
+		}
+
+		template<typename... ARGS>
+		lisk::expression operator()(const ARGS &...values)
+		{
+			if (lambda)
+			{
+				if (call_env._map._node.use_count() != 1 ||
+				    !call_env._map.value().map.empty())
+				{
+					call_env = lisk::environment::extends(lambda->captured_env);
+					for (const auto &param : lambda->params)
+						call_env.define_slot(param, lisk::atom::nil{});
+				}
+				auto *slot = call_env._map.value().slots.data();
+				((slot++->second = values), ...);
+				return lambda->apply(call_env, allow_tail);
+			}
+
+			if (!args)
+			{
+				args = lisk::shared_list::create();
+				for (size_t i = 1; i < sizeof...(ARGS); ++i)
+				{
+					auto head = lisk::shared_list::create();
+					head.set_next(args);
+					args = head;
+				}
+			}
+			// The values were already evaluated, quote the ones that would
+			// change if the callable evaluated them again.
+			auto arg = args;
+			((arg.value() = lisk::quoted(values), ++arg), ...);
+			auto result = callable(args, env, allow_tail).first;
+			// Like call_env, the argument list is only reused if the callable
+			// didn't keep any of its nodes, otherwise what it kept would change
+			// with the next call.
+			bool reuse = args._node.unique();
+			for (auto *node = args._node.get(); reuse && node->next;)
+			{
+				reuse = node->next.unique();
+				node  = node->next.get();
+			}
+			if (!reuse) args = {};
+			return result;
+		}
+	};
+
+	// Copy the elements of a list, vector or hash map, in the order that
+	// foreach visits them.
+	bool gather_elements(const lisk::expression &iterable,
+	                     lak::vector<lisk::expression> &out)
+	{
+		if_let_ok (const lisk::vector &v, iterable.get_vector())
+		{
+			out.reserve(v.size());
+			for (const auto &value : v) out.push_back(value);
+		}
+		else if_let_ok (const lisk::hash_map &m, iterable.get_hash_map())
+		{
+			out.reserve(m.size());
+			m.for_each([&](const lisk::atom &key, const lisk::expression &value)
+			           { out.push_back(key_value_pair(key, value)); });
+		}
+		else if (lisk::shared_list l; iterable >> l)
+		{
+			for (const auto &node : l) out.push_back(node.value);
+		}
+		else
+			return false;
+		return true;
+	}
+
+	// The parallel builtins split their elements into at most this many
+	// chunks. How elements are chunked only depends on how many there are, so
+	// preduce groups them the same way whatever the number of threads.
+	constexpr size_t parallel_chunks = 256;
+
+	size_t parallel_grain(size_t count)
+	{
+		return (count + parallel_chunks - 1) / parallel_chunks;
+	}
+
+	// The tasks of a parallel builtin take their evaluation steps from the
+	// thread that started it, a block at a time, which gets back whatever
+	// they didn't use once they've all finished. When those run out, that
+	// thread's step handler is asked for more, so a builtin nested in another
+	// draws from its parent's steps.
+	struct shared_steps
+	{
+		static constexpr size_t block = 1024;
+
+		std::atomic<size_t> remaining;
+		std::atomic<bool> exhausted = false;
+		lak::pair<lisk::eval_step_handler, void *> parent;
+		std::mutex parent_lock;
+
+		shared_steps()
+		: remaining(lisk::eval_step_budget()),
+		  parent(lisk::get_eval_step_handler())
+		{
+			lisk::set_eval_step_budget(0);
+		}
+
+		~shared_steps() { lisk::set_eval_step_budget(remaining.load()); }
+
+		size_t take_block()
+		{
+			size_t current = remaining.load(std::memory_order_relaxed);
+			while (current != 0 &&
+			       !remaining.compare_exchange_weak(
+			         current, current - std::min(current, block)))
+				;
+			return std::min(current, block);
+		}
+
+		static size_t refill(void *context)
+		{
+			auto &self = *static_cast<shared_steps *>(context);
+			if (const size_t steps = self.take_block(); steps != 0) return steps;
+			if (self.exhausted.load()) return 0;
+
+			std::lock_guard lock(self.parent_lock);
+			// Another thread may have been granted more while this one waited.
+			if (const size_t steps = self.take_block(); steps != 0) return steps;
+			if (self.exhausted.load()) return 0;
+
+			const size_t granted =
+			  self.parent.first ? self.parent.first(self.parent.second) : 0;
+			if (granted == 0)
+			{
+				self.exhausted.store(true);
+				return 0;
+			}
+			const size_t steps = std::min(granted, block);
+			self.remaining.fetch_add(granted - steps);
+			return steps;
+		}
+
+		// Calls f with this thread's steps drawn from remaining.
+		template<typename F>
+		void run(F &&f)
+		{
+			struct restore
+			{
+				shared_steps &self;
+				size_t budget = lisk::eval_step_budget();
+				lak::pair<lisk::eval_step_handler, void *> handler =
+				  lisk::set_eval_step_handler(&shared_steps::refill, &self);
+
+				~restore()
+				{
+					self.remaining.fetch_add(lisk::eval_step_budget());
+					lisk::set_eval_step_budget(budget);
+					lisk::set_eval_step_handler(handler.first, handler.second);
+				}
+			} r{*this};
+			lisk::set_eval_step_budget(0);
+			f();
+		}
+	};
+}
+
 lisk::expression lisk::builtin::foreach (lisk::environment &env,
                                          bool allow_tail,
                                          lisk::symbol sym,
-                                         lisk::shared_list iterlist,
+                                         lisk::expression iterable,
                                          lisk::uneval_expr exp)
 {
-	for (const auto &node : iterlist)
+	// The loop variable is a slot in a frame of its own that's reused for every
+	// element. If the body captured the frame, say in a lambda, the next
+	// element gets a new one so the capture keeps its value.
+	auto loop_env = lisk::environment::extends_loop(env, sym);
+	// Returns false once the evaluation runs out of steps.
+	auto body = [&](const lisk::expression &value)
+	{
+		if (!lisk::impl::take_step()) return false;
+		if (loop_env._map._node.use_count() != 1)
+			loop_env = lisk::environment::extends_loop(env, sym);
+		loop_env._map.value().slots[0].second = value;
+		lisk::eval(exp.expr, loop_env, allow_tail);
+		return true;
+	};
+
+	bool finished = true;
+	if_let_ok (const lisk::vector &v, iterable.get_vector())
+	{
+		for (auto it = v.begin(); finished && it != v.end(); ++it)
+			finished = body(*it);
+	}
+	else if_let_ok (const lisk::hash_map &m, iterable.get_hash_map())
 	{
-		lisk::environment new_env = env;
-		new_env.define_expr(sym, node.value);
-		lisk::eval(exp.expr, new_env, allow_tail);
+		m.for_each(
+		  [&](const lisk::atom &key, const lisk::expression &value)
+		  { finished = finished && body(key_value_pair(key, value)); });
 	}
+	else if (lisk::shared_list l; iterable >> l)
+	{
+		for (auto it = l.begin(); finished && it != l.end(); ++it)
+			finished = body(it->value);
+	}
+	else
+		return lisk::type_error(
+		  "Foreach error", iterable, "a list, vector or hash map");
+	if (!finished) return lisk::impl::steps_exceeded();
 	return lisk::atom::nil{};
 }
 
 lisk::expression lisk::builtin::map(lisk::environment &env,
                                     bool allow_tail,
-                                    lisk::shared_list iterlist,
+                                    lisk::expression iterable,
                                     lisk::uneval_expr exp)
 {
 	auto subexp = lisk::eval(exp.expr, env, allow_tail);
-	if (lisk::functor f; subexp >> f)
+	lisk::callable c;
+	if (!(subexp >> c))
+		return subexp.visit(
+		  [](auto &&a)
+		  { return lisk::type_error("Map error", a, "a function or lambda"); });
+
+	direct_call call(c, 1, env, allow_tail);
+
+	// Vectors map to vectors, lists and hash maps map to lists.
+	if_let_ok (const lisk::vector &v, iterable.get_vector())
+	{
+		lisk::vector result;
+		for (const auto &value : v) result.push_back(call(value));
+		return result;
+	}
+	else if_let_ok (const lisk::hash_map &m, iterable.get_hash_map())
 	{
-		auto arg    = lisk::shared_list::create();
 		auto result = lisk::shared_list::create();
 		auto end    = result;
-		for (const auto &node : iterlist)
-		{
-			arg.value()      = node.value;
-			end.next_value() = f(arg, env, allow_tail).first;
-			++end;
-		}
+		m.for_each(
+		  [&](const lisk::atom &key, const lisk::expression &value)
+		  {
+			  end.next_value() = call(key_value_pair(key, value));
+			  ++end;
+		  });
 		return ++result;
 	}
-	else if (lisk::lambda lf; subexp >> lf)
+	else if (lisk::shared_list l; iterable >> l)
 	{
-		auto arg    = lisk::shared_list::create();
 		auto result = lisk::shared_list::create();
 		auto end    = result;
-		for (const auto &node : iterlist)
+		for (const auto &node : l)
 		{
-			arg.value()      = node.value;
-			end.next_value() = lf(arg, env, allow_tail).first;
+			end.next_value() = call(node.value);
 			++end;
 		}
 		return ++result;
 	}
 	else
+		return lisk::type_error(
+		  "Map error", iterable, "a list, vector or hash map");
+}
+
+lisk::expression lisk::builtin::pmap(lisk::environment &env,
+                                     bool allow_tail,
+                                     lisk::expression iterable,
+                                     lisk::uneval_expr exp)
+{
+	auto subexp = lisk::eval(exp.expr, env, allow_tail);
+	lisk::callable c;
+	if (!(subexp >> c))
 		return subexp.visit(
 		  [](auto &&a)
-		  { return lisk::type_error("Map error", a, "a function or lambda"); });
+		  { return lisk::type_error("Pmap error", a, "a function or lambda"); });
+
+	lak::vector<lisk::expression> values;
+	if (!gather_elements(iterable, values))
+		return lisk::type_error(
+		  "Pmap error", iterable, "a list, vector or hash map");
+
+	shared_steps steps;
+	lisk::get_worker_pool().parallel_for(
+	  values.size(),
+	  parallel_grain(values.size()),
+	  [&](size_t begin, size_t end)
+	  {
+		  steps.run(
+		    [&]
+		    {
+			    direct_call call(c, 1, env, allow_tail);
+			    for (size_t i = begin; i < end; ++i) values[i] = call(values[i]);
+		    });
+	  });
+	if (steps.exhausted) return lisk::impl::steps_exceeded();
+
+	if (iterable.is_vector())
+	{
+		lisk::vector result;
+		for (auto &value : values) result.push_back(lak::move(value));
+		return result;
+	}
+
+	auto result = lisk::shared_list::create();
+	auto end    = result;
+	for (auto &value : values)
+	{
+		end.next_value() = lak::move(value);
+		++end;
+	}
+	return ++result;
+}
+
+lisk::expression lisk::builtin::preduce(lisk::environment &env,
+                                        bool allow_tail,
+                                        lisk::expression iterable,
+                                        lisk::expression init,
+                                        lisk::uneval_expr exp)
+{
+	auto subexp = lisk::eval(exp.expr, env, allow_tail);
+	lisk::callable c;
+	if (!(subexp >> c))
+		return subexp.visit(
+		  [](auto &&a)
+		  { return lisk::type_error("Preduce error", a, "a function or lambda"); });
+
+	lak::vector<lisk::expression> values;
+	if (!gather_elements(iterable, values))
+		return lisk::type_error(
+		  "Preduce error", iterable, "a list, vector or hash map");
+
+	// Each chunk is folded from its first element, then the chunks are folded
+	// into init in order.
+	const size_t grain = parallel_grain(values.size());
+	lak::vector<lisk::expression> partials(
+	  grain == 0 ? 0 : (values.size() + grain - 1) / grain);
+
+	bool exhausted;
+	{
+		// Gives this thread its steps back before it folds the chunks.
+		shared_steps steps;
+		lisk::get_worker_pool().parallel_for(
+		  values.size(),
+		  grain,
+		  [&](size_t begin, size_t end)
+		  {
+			  steps.run(
+			    [&]
+			    {
+				    direct_call call(c, 2, env, allow_tail);
+				    lisk::expression result = values[begin];
+				    for (size_t i = begin + 1; i < end && !result.is_exception();
+				         ++i)
+					    result = call(result, values[i]);
+				    partials[begin / grain] = lak::move(result);
+			    });
+		  });
+		exhausted = steps.exhausted;
+	}
+	if (exhausted) return lisk::impl::steps_exceeded();
+
+	direct_call call(c, 2, env, allow_tail);
+	for (const auto &partial : partials)
+	{
+		if (partial.is_exception()) return partial;
+		init = call(init, partial);
+		if (init.is_exception()) break;
+	}
+	return init;
+}
+
+lisk::expression lisk::builtin::pfor(lisk::environment &env,
+                                     bool allow_tail,
+                                     lisk::symbol sym,
+                                     lisk::expression iterable,
+                                     lisk::uneval_expr exp)
+{
+	lak::vector<lisk::expression> values;
+	if (!gather_elements(iterable, values))
+		return lisk::type_error(
+		  "Pfor error", iterable, "a list, vector or hash map");
+
+	// Unlike foreach, definitions made by the body stay in the element's own
+	// frame, nothing that other elements can see is written to.
+	shared_steps steps;
+	lisk::get_worker_pool().parallel_for(
+	  values.size(),
+	  parallel_grain(values.size()),
+	  [&](size_t begin, size_t end)
+	  {
+		  steps.run(
+		    [&]
+		    {
+			    lisk::environment element_env;
+			    for (size_t i = begin; i < end; ++i)
+			    {
+				    if (element_env._map._node.use_count() != 1 ||
+				        !element_env._map.value().map.empty())
+				    {
+					    element_env = lisk::environment::extends(env);
+					    element_env.define_slot(sym, lisk::atom::nil{});
+				    }
+				    element_env._map.value().slots[0].second = values[i];
+				    lisk::eval(exp.expr, element_env, allow_tail);
+			    }
+		    });
+	  });
+	if (steps.exhausted) return lisk::impl::steps_exceeded();
+
+	return lisk::atom::nil{};
 }
 
 lak::pair<lisk::expression, size_t> lisk::builtin::tail_call(
@@ -697,36 +1315,37 @@ lak::pair<lisk::expression, size_t> lisk::builtin::join(lisk::shared_list l,
                                                         lisk::environment &env,
                                                         bool allow_tail)
 {
-	lisk::shared_list first;
-	lisk::shared_list end;
+	lak::vector<lisk::shared_list> lists;
 	size_t count = 0;
 
-	if (lisk::eval(l.value(), env, allow_tail) >> first)
+	for (const auto &node : l)
 	{
 		++count;
-		end = first.last();
+		if (lisk::shared_list list;
+		    lisk::eval(node.value, env, allow_tail) >> list)
+			lists.push_back(list);
+		else
+			return {lisk::type_error("Join error", node.value, "a list"), 0};
 	}
-	else
-	{
+
+	if (lists.empty())
 		return {lisk::type_error("Join error", l.value(), "a list"), 0};
-	}
 
-	for (const auto &node : l.next())
+	// The result shares the last list, the others are copied so that joining
+	// never modifies a list that something else (say another thread) can see.
+	auto result = lisk::shared_list::create();
+	auto end    = result;
+	for (size_t i = 0; i + 1 < lists.size(); ++i)
 	{
-		++count;
-		if (lisk::shared_list next;
-		    lisk::eval(node.value, env, allow_tail) >> next)
+		for (const auto &node : lists[i])
 		{
-			end.set_next(next);
-			end = next.last();
-		}
-		else
-		{
-			return {lisk::type_error("Join error", node.value, "a list"), 0};
+			end.next_value() = node.value;
+			++end;
 		}
 	}
+	end.set_next(lists.back());
 
-	return {first, count};
+	return {++result, count};
 }
 
 lisk::expression lisk::builtin::range_list(lisk::environment &,
@@ -759,6 +1378,43 @@ lak::pair<lisk::expression, size_t> lisk::builtin::make_lambda(
 	return {lisk::callable(lisk::lambda(l, env, allow_tail)), 2};
 }
 
+lak::pair<lisk::expression, size_t> lisk::builtin::make_vector(
+  lisk::shared_list l, lisk::environment &env, bool allow_tail)
+{
+	lisk::vector result;
+	size_t count = 0;
+	for (const auto &node : l)
+	{
+		result.push_back(lisk::eval(node.value, env, allow_tail));
+		++count;
+	}
+	return {result, count};
+}
+
+lak::pair<lisk::expression, size_t> lisk::builtin::make_hash_map(
+  lisk::shared_list l, lisk::environment &env, bool allow_tail)
+{
+	lisk::hash_map result;
+	lisk::list_reader reader(l, env, allow_tail);
+	size_t count = 0;
+	while (reader.list)
+	{
+		lisk::atom key;
+		lisk::expression value;
+		if (!(reader >> key))
+			return {lisk::type_error("Hash map error", reader.list.value(), "a key"),
+			        0};
+		if (!(reader >> value))
+			return {lisk::exception{"Hash map error: missing value for key '" +
+			                        to_string(key) + "'"},
+			        0};
+		if (!result.set(key, lak::move(value)))
+			return {lisk::type_error("Hash map error", key, "a hashable key"), 0};
+		count += 2;
+	}
+	return {result, count};
+}
+
 lisk::expression lisk::builtin::make_uint(lisk::environment &,
                                           bool,
                                           lisk::expression exp)
@@ -821,7 +1477,7 @@ lisk::expression lisk::builtin::parse_string(lisk::environment &,
                                              bool,
                                              lisk::string str)
 {
-	return lisk::parse(lisk::tokenise(str));
+	return lisk::parse_source(str);
 }
 
 lak::pair<lisk::expression, size_t> lisk::builtin::print_string(
@@ -858,7 +1514,9 @@ lisk::expression lisk::builtin::add(lisk::environment &,
                                     lisk::number a,
                                     lisk::number b)
 {
-	return lisk::atom{a + b};
+	if (const auto err = lisk::checked_add(a, b, a); err != lisk::arithmetic_error::none)
+		return lisk::arithmetic_exception("Add error", err);
+	return lisk::atom{a};
 }
 
 lisk::expression lisk::builtin::sub(lisk::environment &,
@@ -866,7 +1524,9 @@ lisk::expression lisk::builtin::sub(lisk::environment &,
                                     lisk::number a,
                                     lisk::number b)
 {
-	return lisk::atom{a - b};
+	if (const auto err = lisk::checked_sub(a, b, a); err != lisk::arithmetic_error::none)
+		return lisk::arithmetic_exception("Sub error", err);
+	return lisk::atom{a};
 }
 
 lisk::expression lisk::builtin::mul(lisk::environment &,
@@ -874,7 +1534,9 @@ lisk::expression lisk::builtin::mul(lisk::environment &,
                                     lisk::number a,
                                     lisk::number b)
 {
-	return lisk::atom{a * b};
+	if (const auto err = lisk::checked_mul(a, b, a); err != lisk::arithmetic_error::none)
+		return lisk::arithmetic_exception("Mul error", err);
+	return lisk::atom{a};
 }
 
 lisk::expression lisk::builtin::div(lisk::environment &,
@@ -882,83 +1544,286 @@ lisk::expression lisk::builtin::div(lisk::environment &,
                                     lisk::number a,
                                     lisk::number b)
 {
-	return lisk::atom{a / b};
+	if (const auto err = lisk::checked_div(a, b, a); err != lisk::arithmetic_error::none)
+		return lisk::arithmetic_exception("Div error", err);
+	return lisk::atom{a};
+}
+
+namespace
+{
+	// Fold the evaluated arguments into a number in place, same type runs of
+	// operands stay in their native type.
+	lak::pair<lisk::expression, size_t> fold_numbers(
+	  lisk::shared_list l,
+	  lisk::environment &env,
+	  bool allow_tail,
+	  lisk::arithmetic_error (*op)(const lisk::number &,
+	                               const lisk::number &,
+	                               lisk::number &),
+	  const char *error)
+	{
+		if (!l) return {lisk::atom::nil{}, 0};
+
+		lisk::number result;
+		size_t count = 0;
+
+		for (const auto &it : l)
+		{
+			lisk::number n;
+			if (!(lisk::eval(it.value, env, allow_tail) >> n))
+				return {lisk::type_error(error, it.value, "a number"), 0};
+
+			if (count++ == 0)
+				result = n;
+			else if (const auto err = op(result, n, result);
+			         err != lisk::arithmetic_error::none)
+				return {lisk::arithmetic_exception(error, err), 0};
+		}
+
+		return {lisk::expression{lisk::atom{result}}, count};
+	}
 }
 
 lak::pair<lisk::expression, size_t> lisk::builtin::sum(lisk::shared_list l,
                                                        lisk::environment &env,
                                                        bool allow_tail)
 {
-	if (!l) return {lisk::atom::nil{}, 0};
+	return fold_numbers(l, env, allow_tail, lisk::checked_add, "Add error");
+}
 
-	lisk::number result;
-	size_t count = 0;
+lak::pair<lisk::expression, size_t> lisk::builtin::product(
+  lisk::shared_list l, lisk::environment &env, bool allow_tail)
+{
+	return fold_numbers(l, env, allow_tail, lisk::checked_mul, "Mul error");
+}
 
-	if (lisk::number n; lisk::eval(l.value(), env, allow_tail) >> n)
-	{
-		++count;
-		result = n;
-	}
-	else
+namespace
+{
+	lisk::expression make_array_expression(lisk::numeric_array arr)
 	{
-		return {lisk::type_error("Add error", l.value(), "a number"), 0};
+		return lisk::atom{lisk::pointer(
+		  lak::shared_ptr<lisk::numeric_array>::make(lak::move(arr)))};
 	}
+}
 
-	for (const auto &it : l.next())
-	{
-		++count;
-		if (lisk::number n; lisk::eval(it.value, env, allow_tail) >> n)
-		{
-			result += n;
-		}
-		else
-		{
-			return {lisk::type_error("Add error", l.value(), "a number"), 0};
-		}
-	}
+lisk::expression lisk::builtin::hash_size(lisk::environment &,
+                                          bool,
+                                          lisk::hash_map m)
+{
+	return lisk::atom{lisk::number{lisk::uint_t(m.size())}};
+}
 
-	return {lisk::expression{lisk::atom{result}}, count};
+lisk::expression lisk::builtin::hash_get(lisk::environment &,
+                                         bool,
+                                         lisk::hash_map m,
+                                         lisk::expression key)
+{
+	lisk::atom a;
+	if (!(key >> a)) return lisk::type_error("Hash get error", key, "an atom");
+	if_let_ok (const auto &value, m.find(a))
+		return value;
+	return lisk::atom::nil{};
 }
 
-lak::pair<lisk::expression, size_t> lisk::builtin::product(
-  lisk::shared_list l, lisk::environment &env, bool allow_tail)
+lisk::expression lisk::builtin::hash_contains(lisk::environment &,
+                                              bool,
+                                              lisk::hash_map m,
+                                              lisk::expression key)
+{
+	lisk::atom a;
+	if (!(key >> a))
+		return lisk::type_error("Hash contains error", key, "an atom");
+	return lisk::atom{m.find(a).is_ok()};
+}
+
+lisk::expression lisk::builtin::hash_set(lisk::environment &,
+                                         bool,
+                                         lisk::hash_map m,
+                                         lisk::expression key,
+                                         lisk::expression value)
+{
+	lisk::atom a;
+	if (!(key >> a) || !m.set(a, lak::move(value)))
+		return lisk::type_error("Hash set error", key, "a hashable key");
+	return m;
+}
+
+lisk::expression lisk::builtin::hash_remove(lisk::environment &,
+                                            bool,
+                                            lisk::hash_map m,
+                                            lisk::expression key)
+{
+	lisk::atom a;
+	if (!(key >> a))
+		return lisk::type_error("Hash remove error", key, "an atom");
+	m.remove(a);
+	return m;
+}
+
+lisk::expression lisk::builtin::hash_keys(lisk::environment &,
+                                          bool,
+                                          lisk::hash_map m)
+{
+	auto result = lisk::shared_list::create();
+	auto end    = result;
+	m.for_each(
+	  [&](const lisk::atom &key, const lisk::expression &)
+	  {
+		  end.next_value() = key;
+		  ++end;
+	  });
+	return ++result;
+}
+
+lisk::expression lisk::builtin::make_array(lisk::environment &,
+                                           bool,
+                                           lisk::shared_list l)
+{
+	if_let_ok (lisk::numeric_array arr, lisk::to_numeric_array(l))
+		return make_array_expression(lak::move(arr));
+	return lisk::type_error("Array error", l, "a list of numbers");
+}
+
+lisk::expression lisk::builtin::array_list(
+  lisk::environment &, bool, lak::shared_ptr<lisk::numeric_array> arr)
+{
+	return lisk::to_list(*arr);
+}
+
+lisk::expression lisk::builtin::array_size(
+  lisk::environment &, bool, lak::shared_ptr<lisk::numeric_array> arr)
+{
+	return lisk::atom{lisk::number{lisk::uint_t(arr->size())}};
+}
+
+lisk::expression lisk::builtin::array_sum(
+  lisk::environment &, bool, lak::shared_ptr<lisk::numeric_array> arr)
 {
-	if (!l) return {lisk::atom::nil{}, 0};
+	lisk::number result;
+	if (const auto err = lisk::array_sum(*arr, result);
+	    err != lisk::arithmetic_error::none)
+		return lisk::arithmetic_exception("Add error", err);
+	return lisk::atom{result};
+}
 
+lisk::expression lisk::builtin::array_product(
+  lisk::environment &, bool, lak::shared_ptr<lisk::numeric_array> arr)
+{
 	lisk::number result;
-	size_t count = 0;
+	if (const auto err = lisk::array_product(*arr, result);
+	    err != lisk::arithmetic_error::none)
+		return lisk::arithmetic_exception("Mul error", err);
+	return lisk::atom{result};
+}
 
-	if (lisk::number n; lisk::eval(l.value(), env, allow_tail) >> n)
-	{
-		++count;
-		result = n;
-	}
-	else
-	{
-		return {lisk::type_error("Mul error", l.value(), "a number"), 0};
-	}
+lisk::expression lisk::builtin::array_min(
+  lisk::environment &, bool, lak::shared_ptr<lisk::numeric_array> arr)
+{
+	if (lisk::number result; lisk::array_min(*arr, result))
+		return lisk::atom{result};
+	return lisk::atom::nil{};
+}
 
-	for (const auto &it : l.next())
-	{
-		++count;
-		if (lisk::number n; lisk::eval(it.value, env, allow_tail) >> n)
-		{
-			result *= n;
-		}
-		else
-		{
-			return {lisk::type_error("Mul error", l.value(), "a number"), 0};
-		}
-	}
+lisk::expression lisk::builtin::array_max(
+  lisk::environment &, bool, lak::shared_ptr<lisk::numeric_array> arr)
+{
+	if (lisk::number result; lisk::array_max(*arr, result))
+		return lisk::atom{result};
+	return lisk::atom::nil{};
+}
 
-	return {lisk::expression{lisk::atom{result}}, count};
+lisk::expression lisk::builtin::array_dot(
+  lisk::environment &,
+  bool,
+  lak::shared_ptr<lisk::numeric_array> a,
+  lak::shared_ptr<lisk::numeric_array> b)
+{
+	if (a->size() != b->size())
+		return lisk::exception{"Dot error: arrays have different sizes"};
+	lisk::number result;
+	if (const auto err = lisk::array_dot(*a, *b, result);
+	    err != lisk::arithmetic_error::none)
+		return lisk::arithmetic_exception("Dot error", err);
+	return lisk::atom{result};
+}
+
+lisk::expression lisk::builtin::array_add(
+  lisk::environment &,
+  bool,
+  lak::shared_ptr<lisk::numeric_array> a,
+  lak::shared_ptr<lisk::numeric_array> b)
+{
+	if (a->size() != b->size())
+		return lisk::exception{"Add error: arrays have different sizes"};
+	lisk::numeric_array result;
+	if (const auto err = lisk::array_add(*a, *b, result);
+	    err != lisk::arithmetic_error::none)
+		return lisk::arithmetic_exception("Add error", err);
+	return make_array_expression(lak::move(result));
+}
+
+lisk::expression lisk::builtin::array_mul(
+  lisk::environment &,
+  bool,
+  lak::shared_ptr<lisk::numeric_array> a,
+  lak::shared_ptr<lisk::numeric_array> b)
+{
+	if (a->size() != b->size())
+		return lisk::exception{"Mul error: arrays have different sizes"};
+	lisk::numeric_array result;
+	if (const auto err = lisk::array_mul(*a, *b, result);
+	    err != lisk::arithmetic_error::none)
+		return lisk::arithmetic_exception("Mul error", err);
+	return make_array_expression(lak::move(result));
+}
+
+lisk::expression lisk::builtin::vector_length(lisk::environment &,
+                                              bool,
+                                              lisk::vector v)
+{
+	return lisk::atom{lisk::number{lisk::uint_t(v.size())}};
+}
+
+lisk::expression lisk::builtin::vector_ref(lisk::environment &,
+                                           bool,
+                                           lisk::vector v,
+                                           lisk::uint_t index)
+{
+	if_let_ok (const auto &value, v.at(index))
+		return value;
+	return lisk::exception{"Index error: " + lisk::to_string(index) +
+	                       " is out of range for a vector of length " +
+	                       lisk::to_string(lisk::uint_t(v.size()))};
+}
+
+lisk::expression lisk::builtin::vector_slice(lisk::environment &,
+                                             bool,
+                                             lisk::vector v,
+                                             lisk::uint_t begin,
+                                             lisk::uint_t end)
+{
+	if (begin > end || end > v.size())
+		return lisk::exception{"Slice error: [" + lisk::to_string(begin) + ", " +
+		                       lisk::to_string(end) +
+		                       ") is out of range for a vector of length " +
+		                       lisk::to_string(lisk::uint_t(v.size()))};
+	return v.slice(begin, end);
+}
+
+lisk::expression lisk::builtin::vector_push(lisk::environment &,
+                                            bool,
+                                            lisk::vector v,
+                                            lisk::expression value)
+{
+	v.push_back(lak::move(value));
+	return v;
 }
 
 lisk::environment lisk::builtin::default_env()
 {
 	lisk::environment e;
 
-	e.define_atom("pi", lisk::atom(lisk::number(3.14159L)));
+	e.define_atom("pi", lisk::atom(lisk::number(lisk::real_t(3.14159L))));
 
 	e.define_functor("env", LISK_FUNCTOR_WRAPPER(list_env));
 	e.define_functor("null?", LISK_FUNCTOR_WRAPPER(null_check));
@@ -969,11 +1834,15 @@ lisk::environment lisk::builtin::default_env()
 	e.define_functor("define", LISK_FUNCTOR_WRAPPER(define));
 	e.define_functor("eval", LISK_FUNCTOR_WRAPPER(evaluate));
 	e.define_functor("eval-stack", evaluate_stack);
+	e.define_functor("quote", LISK_FUNCTOR_WRAPPER(quote));
 	e.define_functor("begin", begin);
 	e.define_functor("repeat", LISK_FUNCTOR_WRAPPER(repeat));
 	e.define_functor("while", LISK_FUNCTOR_WRAPPER(repeat_while));
 	e.define_functor("foreach", LISK_FUNCTOR_WRAPPER(foreach));
 	e.define_functor("map", LISK_FUNCTOR_WRAPPER(map));
+	e.define_functor("pmap", LISK_FUNCTOR_WRAPPER(pmap));
+	e.define_functor("preduce", LISK_FUNCTOR_WRAPPER(preduce));
+	e.define_functor("pfor", LISK_FUNCTOR_WRAPPER(pfor));
 	e.define_functor("tail", tail_call);
 
 	e.define_functor("car", LISK_FUNCTOR_WRAPPER(car));
@@ -983,6 +1852,8 @@ lisk::environment lisk::builtin::default_env()
 
 	e.define_functor("range", LISK_FUNCTOR_WRAPPER(range_list));
 	e.define_functor("list", make_list);
+	e.define_functor("vector", make_vector);
+	e.define_functor("hash-map", make_hash_map);
 	e.define_functor("lambda", make_lambda);
 	e.define_functor("uint", LISK_FUNCTOR_WRAPPER(make_uint));
 	e.define_functor("sint", LISK_FUNCTOR_WRAPPER(make_sint));
@@ -1002,5 +1873,51 @@ lisk::environment lisk::builtin::default_env()
 	e.define_functor("sum", sum);
 	e.define_functor("product", product);
 
+	e.define_functor("vector-length", LISK_FUNCTOR_WRAPPER(vector_length));
+	e.define_functor("vector-ref", LISK_FUNCTOR_WRAPPER(vector_ref));
+	e.define_functor("vector-slice", LISK_FUNCTOR_WRAPPER(vector_slice));
+	e.define_functor("vector-push", LISK_FUNCTOR_WRAPPER(vector_push));
+
+	e.define_functor("hash-size", LISK_FUNCTOR_WRAPPER(hash_size));
+	e.define_functor("hash-get", LISK_FUNCTOR_WRAPPER(hash_get));
+	e.define_functor("hash-contains?", LISK_FUNCTOR_WRAPPER(hash_contains));
+	e.define_functor("hash-set", LISK_FUNCTOR_WRAPPER(hash_set));
+	e.define_functor("hash-remove", LISK_FUNCTOR_WRAPPER(hash_remove));
+	e.define_functor("hash-keys", LISK_FUNCTOR_WRAPPER(hash_keys));
+
+	e.define_functor("array", LISK_FUNCTOR_WRAPPER(make_array));
+	e.define_functor("array-list", LISK_FUNCTOR_WRAPPER(array_list));
+	e.define_functor("array-size", LISK_FUNCTOR_WRAPPER(array_size));
+	e.define_functor("array-sum", LISK_FUNCTOR_WRAPPER(array_sum));
+	e.define_functor("array-product", LISK_FUNCTOR_WRAPPER(array_product));
+	e.define_functor("array-min", LISK_FUNCTOR_WRAPPER(array_min));
+	e.define_functor("array-max", LISK_FUNCTOR_WRAPPER(array_max));
+	e.define_functor("array-dot", LISK_FUNCTOR_WRAPPER(array_dot));
+	e.define_functor("array-add", LISK_FUNCTOR_WRAPPER(array_add));
+	e.define_functor("array-mul", LISK_FUNCTOR_WRAPPER(array_mul));
+
 	return e;
 }
+
+const lisk::environment &lisk::builtin::shared_env()
+{
+	// Never destroyed: releasing its frames needs the thread's release queues,
+	// which may already be gone by the time statics are destroyed.
+	static const lisk::environment *builtins = []
+	{
+		// Outlives any allocator that's selected by whoever gets here first.
+		lisk::node_allocator *previous = lisk::set_node_allocator(nullptr);
+		auto *e                        = new lisk::environment(default_env());
+		e->freeze();
+		lisk::set_node_allocator(previous);
+		return e;
+	}();
+	return *builtins;
+}
+
+lisk::functor lisk::builtin::find_builtin(const lisk::symbol &name)
+{
+	lisk::functor result = nullptr;
+	if (const auto *expr = shared_env().find(name); expr) *expr >> result;
+	return result;
+}
@@ -7,7 +7,7 @@
 
 lisk::string lisk::to_string(const lisk::number &num)
 {
-	return lak::visit([](auto &&v) { return to_string(v); }, num._value);
+	return num.visit([](auto &&v) { return to_string(v); });
 }
 
 const lisk::string &lisk::type_name(const lisk::number &)
@@ -49,6 +49,20 @@ const lisk::string &lisk::type_name(lisk::real_t)
 	return name;
 }
 
+lisk::string lisk::to_string(lisk::arithmetic_error err)
+{
+	switch (err)
+	{
+		case lisk::arithmetic_error::none:
+			return "no error";
+		case lisk::arithmetic_error::overflow:
+			return "integer overflow";
+		case lisk::arithmetic_error::divide_by_zero:
+			return "integer division by zero";
+	}
+	return "unknown arithmetic error";
+}
+
 bool operator>>(const lisk::expression &arg, lisk::number &out)
 {
 	if_let_ok (const auto &atom, arg.get_atom())
@@ -0,0 +1,480 @@
+#include "lisk/numeric_array.hpp"
+
+#include "lisk/lisk.hpp"
+
+#include <type_traits>
+
+namespace
+{
+	// The kernels work on blocks of this many elements with one accumulator
+	// per lane. The lanes don't depend on each other, so the compiler turns
+	// each block into SIMD instructions for whatever the target supports.
+	// Whatever doesn't fill a block is handled one element at a time.
+	constexpr size_t lanes = 8;
+
+	// Wrapping for uint_t, IEEE 754 for real_t.
+	template<typename T>
+	T sum_kernel(const T *data, size_t size)
+	{
+		T acc[lanes] = {};
+		size_t i     = 0;
+		for (; i + lanes <= size; i += lanes)
+			for (size_t j = 0; j < lanes; ++j) acc[j] += data[i + j];
+		for (; i < size; ++i) acc[0] += data[i];
+
+		T result = 0;
+		for (size_t j = 0; j < lanes; ++j) result += acc[j];
+		return result;
+	}
+
+	// Add x to acc with wrapping arithmetic, counting signed overflows
+	// (+1 upwards, -1 downwards) in wraps.
+	inline void wrapping_add(lisk::uint_t &acc, lisk::sint_t &wraps, lisk::uint_t x)
+	{
+		const lisk::uint_t result = acc + x;
+		// Signed overflow happens iff both operands have the opposite sign to
+		// the result, overflow is then -1 and otherwise 0.
+		const lisk::sint_t overflow =
+		  lisk::sint_t((acc ^ result) & (x ^ result)) >> 63;
+		wraps -= overflow & ((lisk::sint_t(result) >> 63) | 1);
+		acc = result;
+	}
+
+	// Sums in wrapping arithmetic, the exact sum fits in a sint_t iff the
+	// overflows cancel out.
+	bool sint_sum_kernel(const lisk::sint_t *data,
+	                     size_t size,
+	                     lisk::sint_t &out)
+	{
+		lisk::uint_t acc[lanes]   = {};
+		lisk::sint_t wraps[lanes] = {};
+		size_t i                  = 0;
+		for (; i + lanes <= size; i += lanes)
+			for (size_t j = 0; j < lanes; ++j)
+				wrapping_add(acc[j], wraps[j], lisk::uint_t(data[i + j]));
+
+		lisk::uint_t result       = 0;
+		lisk::sint_t result_wraps = 0;
+		for (size_t j = 0; j < lanes; ++j)
+		{
+			wrapping_add(result, result_wraps, acc[j]);
+			result_wraps += wraps[j];
+		}
+		for (; i < size; ++i)
+			wrapping_add(result, result_wraps, lisk::uint_t(data[i]));
+
+		if (result_wraps != 0) return false;
+		out = lisk::sint_t(result);
+		return true;
+	}
+
+	template<typename T>
+	T product_kernel(const T *data, size_t size)
+	{
+		T acc[lanes];
+		for (size_t j = 0; j < lanes; ++j) acc[j] = 1;
+		size_t i = 0;
+		for (; i + lanes <= size; i += lanes)
+			for (size_t j = 0; j < lanes; ++j) acc[j] *= data[i + j];
+		for (; i < size; ++i) acc[0] *= data[i];
+
+		T result = 1;
+		for (size_t j = 0; j < lanes; ++j) result *= acc[j];
+		return result;
+	}
+
+	bool sint_product_kernel(const lisk::sint_t *data,
+	                         size_t size,
+	                         lisk::sint_t &out)
+	{
+		lisk::sint_t result = 1;
+		for (size_t i = 0; i < size; ++i)
+			if (lisk::impl::mul_overflows(result, data[i], result)) return false;
+		out = result;
+		return true;
+	}
+
+	template<typename T, typename COMPARE>
+	T select_kernel(const T *data, size_t size, COMPARE compare)
+	{
+		T acc[lanes];
+		for (size_t j = 0; j < lanes; ++j) acc[j] = data[0];
+		size_t i = 0;
+		for (; i + lanes <= size; i += lanes)
+			for (size_t j = 0; j < lanes; ++j)
+				acc[j] = compare(data[i + j], acc[j]) ? data[i + j] : acc[j];
+		for (; i < size; ++i)
+			acc[0] = compare(data[i], acc[0]) ? data[i] : acc[0];
+
+		T result = acc[0];
+		for (size_t j = 1; j < lanes; ++j)
+			result = compare(acc[j], result) ? acc[j] : result;
+		return result;
+	}
+
+	template<typename T>
+	T dot_kernel(const T *a, const T *b, size_t size)
+	{
+		T acc[lanes] = {};
+		size_t i     = 0;
+		for (; i + lanes <= size; i += lanes)
+			for (size_t j = 0; j < lanes; ++j) acc[j] += a[i + j] * b[i + j];
+		for (; i < size; ++i) acc[0] += a[i] * b[i];
+
+		T result = 0;
+		for (size_t j = 0; j < lanes; ++j) result += acc[j];
+		return result;
+	}
+
+	bool sint_dot_kernel(const lisk::sint_t *a,
+	                     const lisk::sint_t *b,
+	                     size_t size,
+	                     lisk::sint_t &out)
+	{
+		lisk::sint_t result = 0;
+		for (size_t i = 0; i < size; ++i)
+		{
+			lisk::sint_t product;
+			if (lisk::impl::mul_overflows(a[i], b[i], product) ||
+			    lisk::impl::add_overflows(result, product, result))
+				return false;
+		}
+		out = result;
+		return true;
+	}
+
+	// Element-wise kernels compute a whole block before storing it, so the
+	// compiler doesn't have to prove that out doesn't alias a or b.
+	template<typename T, typename OP>
+	void elementwise_kernel(const T *a, const T *b, T *out, size_t size, OP op)
+	{
+		size_t i = 0;
+		for (; i + lanes <= size; i += lanes)
+		{
+			T block[lanes];
+			for (size_t j = 0; j < lanes; ++j) block[j] = op(a[i + j], b[i + j]);
+			for (size_t j = 0; j < lanes; ++j) out[i + j] = block[j];
+		}
+		for (; i < size; ++i) out[i] = op(a[i], b[i]);
+	}
+
+	bool sint_add_kernel(const lisk::sint_t *a,
+	                     const lisk::sint_t *b,
+	                     lisk::sint_t *out,
+	                     size_t size)
+	{
+		// Accumulate the overflow bits rather than branching on them so the loop
+		// stays vectorisable.
+		auto add = [](lisk::sint_t a, lisk::sint_t b, lisk::uint_t &overflow)
+		{
+			const lisk::uint_t x = lisk::uint_t(a), y = lisk::uint_t(b);
+			const lisk::uint_t result = x + y;
+			overflow |= (x ^ result) & (y ^ result);
+			return lisk::sint_t(result);
+		};
+
+		lisk::uint_t overflow[lanes] = {};
+		size_t i                     = 0;
+		for (; i + lanes <= size; i += lanes)
+		{
+			lisk::sint_t block[lanes];
+			for (size_t j = 0; j < lanes; ++j)
+				block[j] = add(a[i + j], b[i + j], overflow[j]);
+			for (size_t j = 0; j < lanes; ++j) out[i + j] = block[j];
+		}
+		for (; i < size; ++i) out[i] = add(a[i], b[i], overflow[0]);
+
+		lisk::uint_t result = 0;
+		for (size_t j = 0; j < lanes; ++j) result |= overflow[j];
+		return lisk::sint_t(result) >= 0;
+	}
+
+	bool sint_mul_kernel(const lisk::sint_t *a,
+	                     const lisk::sint_t *b,
+	                     lisk::sint_t *out,
+	                     size_t size)
+	{
+		for (size_t i = 0; i < size; ++i)
+			if (lisk::impl::mul_overflows(a[i], b[i], out[i])) return false;
+		return true;
+	}
+
+	template<typename VECTOR>
+	using element_t = typename std::remove_cvref_t<VECTOR>::value_type;
+
+	// The usual arithmetic conversions, except that a mix of sints and uints
+	// is promoted to real_t, the uint_t they'd otherwise share wraps negative
+	// elements around to huge values.
+	template<typename A, typename B>
+	using array_common_t = std::conditional_t<
+	  (std::is_same_v<A, lisk::sint_t> && std::is_same_v<B, lisk::uint_t>) ||
+	    (std::is_same_v<A, lisk::uint_t> && std::is_same_v<B, lisk::sint_t>),
+	  lisk::real_t,
+	  std::common_type_t<A, B>>;
+
+	// Call f with the data of a and b converted to their common element type,
+	// and the element count.
+	template<typename F>
+	auto with_common_type(const lisk::numeric_array &a,
+	                      const lisk::numeric_array &b,
+	                      F &&f)
+	{
+		return a.visit(
+		  [&](const auto &x)
+		  {
+			  return b.visit(
+			    [&](const auto &y)
+			    {
+				    using type =
+				      array_common_t<element_t<decltype(x)>, element_t<decltype(y)>>;
+
+				    lak::vector<type> x_copy, y_copy;
+				    const type *x_data, *y_data;
+				    if constexpr (std::is_same_v<element_t<decltype(x)>, type>)
+					    x_data = x.data();
+				    else
+					    x_data = (x_copy = lak::vector<type>(x.begin(), x.end())).data();
+				    if constexpr (std::is_same_v<element_t<decltype(y)>, type>)
+					    y_data = y.data();
+				    else
+					    y_data = (y_copy = lak::vector<type>(y.begin(), y.end())).data();
+
+				    return f(x_data, y_data, x.size());
+			    });
+		  });
+	}
+}
+
+lisk::numeric_array::numeric_array(lak::vector<lisk::uint_t> values)
+: _value(lak::in_place_index<value_type::index_of<lak::vector<lisk::uint_t>>>,
+         lak::move(values))
+{
+}
+
+lisk::numeric_array::numeric_array(lak::vector<lisk::sint_t> values)
+: _value(lak::in_place_index<value_type::index_of<lak::vector<lisk::sint_t>>>,
+         lak::move(values))
+{
+}
+
+lisk::numeric_array::numeric_array(lak::vector<lisk::real_t> values)
+: _value(lak::in_place_index<value_type::index_of<lak::vector<lisk::real_t>>>,
+         lak::move(values))
+{
+}
+
+size_t lisk::numeric_array::size() const
+{
+	return visit([](const auto &values) { return values.size(); });
+}
+
+lisk::number lisk::numeric_array::operator[](size_t index) const
+{
+	return visit([&](const auto &values) { return lisk::number(values[index]); });
+}
+
+lisk::string lisk::to_string(const lisk::numeric_array &arr)
+{
+	lisk::string result = "#(";
+	arr.visit(
+	  [&](const auto &values)
+	  {
+		  for (size_t i = 0; i < values.size(); ++i)
+		  {
+			  if (i != 0) result += " ";
+			  result += to_string(values[i]);
+		  }
+	  });
+	return result + ")";
+}
+
+const lisk::string &lisk::type_name(const lisk::numeric_array &)
+{
+	const static lisk::string name = "numeric_array";
+	return name;
+}
+
+lak::result<lisk::numeric_array> lisk::to_numeric_array(
+  const lisk::shared_list &l)
+{
+	size_t count  = 0;
+	bool any_uint = false;
+	bool any_sint = false;
+	bool any_real = false;
+	for (const auto &it : l)
+	{
+		lisk::number n;
+		if (!(it.value >> n)) return lak::err_t{};
+		any_uint |= n.is_uint();
+		any_sint |= n.is_sint();
+		any_real |= n.is_real();
+		++count;
+	}
+
+	auto fill = [&]<typename T>(lak::vector<T> values) -> lisk::numeric_array
+	{
+		values.reserve(count);
+		for (const auto &it : l)
+		{
+			lisk::number n;
+			it.value >> n;
+			values.push_back(n.visit([](auto v) { return T(v); }));
+		}
+		return values;
+	};
+
+	if (any_real || (any_uint && any_sint))
+		return lak::ok_t{fill(lak::vector<lisk::real_t>{})};
+	if (any_uint) return lak::ok_t{fill(lak::vector<lisk::uint_t>{})};
+	return lak::ok_t{fill(lak::vector<lisk::sint_t>{})};
+}
+
+lisk::shared_list lisk::to_list(const lisk::numeric_array &arr)
+{
+	auto result = lisk::shared_list::create();
+	auto end    = result;
+	arr.visit(
+	  [&](const auto &values)
+	  {
+		  for (const auto &v : values)
+		  {
+			  end.next_value() = lisk::atom{lisk::number{v}};
+			  ++end;
+		  }
+	  });
+	return ++result;
+}
+
+lisk::arithmetic_error lisk::array_sum(const lisk::numeric_array &arr,
+                                       lisk::number &out)
+{
+	return arr.visit(
+	  [&](const auto &values) -> lisk::arithmetic_error
+	  {
+		  using type = element_t<decltype(values)>;
+		  if constexpr (std::is_same_v<type, lisk::sint_t>)
+		  {
+			  lisk::sint_t result;
+			  if (!sint_sum_kernel(values.data(), values.size(), result))
+				  return lisk::arithmetic_error::overflow;
+			  out = result;
+		  }
+		  else
+			  out = sum_kernel(values.data(), values.size());
+		  return lisk::arithmetic_error::none;
+	  });
+}
+
+lisk::arithmetic_error lisk::array_product(const lisk::numeric_array &arr,
+                                           lisk::number &out)
+{
+	return arr.visit(
+	  [&](const auto &values) -> lisk::arithmetic_error
+	  {
+		  using type = element_t<decltype(values)>;
+		  if constexpr (std::is_same_v<type, lisk::sint_t>)
+		  {
+			  lisk::sint_t result;
+			  if (!sint_product_kernel(values.data(), values.size(), result))
+				  return lisk::arithmetic_error::overflow;
+			  out = result;
+		  }
+		  else
+			  out = product_kernel(values.data(), values.size());
+		  return lisk::arithmetic_error::none;
+	  });
+}
+
+bool lisk::array_min(const lisk::numeric_array &arr, lisk::number &out)
+{
+	return arr.visit(
+	  [&](const auto &values)
+	  {
+		  if (values.empty()) return false;
+		  out = select_kernel(values.data(),
+		                      values.size(),
+		                      [](const auto &a, const auto &b) { return a < b; });
+		  return true;
+	  });
+}
+
+bool lisk::array_max(const lisk::numeric_array &arr, lisk::number &out)
+{
+	return arr.visit(
+	  [&](const auto &values)
+	  {
+		  if (values.empty()) return false;
+		  out = select_kernel(values.data(),
+		                      values.size(),
+		                      [](const auto &a, const auto &b) { return a > b; });
+		  return true;
+	  });
+}
+
+lisk::arithmetic_error lisk::array_dot(const lisk::numeric_array &a,
+                                       const lisk::numeric_array &b,
+                                       lisk::number &out)
+{
+	return with_common_type(
+	  a,
+	  b,
+	  [&]<typename T>(const T *x, const T *y, size_t size) -> lisk::arithmetic_error
+	  {
+		  if constexpr (std::is_same_v<T, lisk::sint_t>)
+		  {
+			  lisk::sint_t result;
+			  if (!sint_dot_kernel(x, y, size, result))
+				  return lisk::arithmetic_error::overflow;
+			  out = result;
+		  }
+		  else
+			  out = dot_kernel(x, y, size);
+		  return lisk::arithmetic_error::none;
+	  });
+}
+
+lisk::arithmetic_error lisk::array_add(const lisk::numeric_array &a,
+                                       const lisk::numeric_array &b,
+                                       lisk::numeric_array &out)
+{
+	return with_common_type(
+	  a,
+	  b,
+	  [&]<typename T>(const T *x, const T *y, size_t size) -> lisk::arithmetic_error
+	  {
+		  lak::vector<T> result(size);
+		  if constexpr (std::is_same_v<T, lisk::sint_t>)
+		  {
+			  if (!sint_add_kernel(x, y, result.data(), size))
+				  return lisk::arithmetic_error::overflow;
+		  }
+		  else
+			  elementwise_kernel(
+			    x, y, result.data(), size, [](T a, T b) { return T(a + b); });
+		  out = lak::move(result);
+		  return lisk::arithmetic_error::none;
+	  });
+}
+
+lisk::arithmetic_error lisk::array_mul(const lisk::numeric_array &a,
+                                       const lisk::numeric_array &b,
+                                       lisk::numeric_array &out)
+{
+	return with_common_type(
+	  a,
+	  b,
+	  [&]<typename T>(const T *x, const T *y, size_t size) -> lisk::arithmetic_error
+	  {
+		  lak::vector<T> result(size);
+		  if constexpr (std::is_same_v<T, lisk::sint_t>)
+		  {
+			  if (!sint_mul_kernel(x, y, result.data(), size))
+				  return lisk::arithmetic_error::overflow;
+		  }
+		  else
+			  elementwise_kernel(
+			    x, y, result.data(), size, [](T a, T b) { return T(a * b); });
+		  out = lak::move(result);
+		  return lisk::arithmetic_error::none;
+	  });
+}
@@ -0,0 +1,154 @@
+#include "lisk/runtime.hpp"
+
+#include "lisk/lisk.hpp"
+
+#include <new>
+
+namespace
+{
+	lisk::expression out_of_memory(const lisk::arena_allocator &arena)
+	{
+		return lisk::exception{"Evaluation exceeded the runtime memory limit of " +
+		                       std::to_string(arena._limit) + " bytes"};
+	}
+
+	std::deque<lisk::arena_allocator> worker_arenas(lisk::arena_allocator &arena,
+	                                                size_t threads)
+	{
+		std::deque<lisk::arena_allocator> result;
+		for (size_t i = 1; i < lisk::worker_pool::thread_count(threads); ++i)
+			result.emplace_back(arena);
+		return result;
+	}
+
+	void select_worker_arena(void *context, size_t index)
+	{
+		auto &arenas = *static_cast<std::deque<lisk::arena_allocator> *>(context);
+		lisk::set_node_allocator(&arenas[index]);
+	}
+
+	void add(lisk::allocation_stats &total, const lisk::allocation_stats &stats)
+	{
+		total.allocations += stats.allocations;
+		total.deallocations += stats.deallocations;
+		total.reused += stats.reused;
+		total.bytes_in_use += stats.bytes_in_use;
+		total.bytes_cached += stats.bytes_cached;
+	}
+
+	// Gives an evaluation the runtime's step budget, and counts the steps it
+	// took.
+	struct step_scope
+	{
+		size_t &steps;
+		size_t budget;
+		size_t previous;
+
+		step_scope(size_t &total, size_t step_budget)
+		: steps(total),
+		  budget(step_budget == 0 ? SIZE_MAX : step_budget),
+		  previous(lisk::eval_step_budget())
+		{
+			lisk::set_eval_step_budget(budget);
+		}
+
+		~step_scope()
+		{
+			// A step handler may have granted more than the budget.
+			if (const size_t left = lisk::eval_step_budget(); left <= budget)
+				steps += budget - left;
+			lisk::set_eval_step_budget(previous);
+		}
+	};
+}
+
+lisk::runtime::scope::scope(lisk::runtime &rt)
+: previous_allocator(lisk::set_node_allocator(&rt._arena)),
+  previous_pool(lisk::set_worker_pool(&rt._pool))
+{
+}
+
+lisk::runtime::scope::~scope()
+{
+	lisk::set_worker_pool(previous_pool);
+	lisk::set_node_allocator(previous_allocator);
+}
+
+lisk::runtime::runtime(const lisk::runtime_options &options)
+: _arena(options.memory_limit),
+  _worker_arenas(worker_arenas(_arena, options.threads)),
+  _pool(options.threads, &select_worker_arena, &_worker_arenas),
+  _step_budget(options.step_budget)
+{
+	// Built outside of the arena, so it isn't counted against the limit.
+	const auto &builtins = lisk::builtin::shared_env();
+	scope s(*this);
+	_env = lisk::environment::extends(builtins);
+}
+
+lisk::runtime::~runtime()
+{
+	scope s(*this);
+
+	// Everything has to actually be destroyed before the arena goes, not
+	// left for a later release_deferred.
+	const bool defer = lisk::deferred_release();
+	lisk::set_deferred_release(false);
+
+	// Lambdas that were defined in the global environment capture it, so
+	// they'd keep it alive through a cycle. Each arena keeps a list of its own
+	// lambdas, so this doesn't touch those of any other runtime.
+	lisk::impl::release_lambdas(_arena);
+	for (auto &arena : _worker_arenas) lisk::impl::release_lambdas(arena);
+	_env = {};
+	lisk::release_deferred();
+
+	lisk::set_deferred_release(defer);
+}
+
+lisk::expression lisk::runtime::eval(const lisk::expression &exp,
+                                     bool allow_tail)
+{
+	scope s(*this);
+	step_scope steps(_steps, _step_budget);
+	++_evaluations;
+	try
+	{
+		return lisk::eval(exp, _env, allow_tail);
+	}
+	catch (const std::bad_alloc &)
+	{
+		return out_of_memory(_arena);
+	}
+}
+
+lisk::expression lisk::runtime::eval_string(const lisk::string &source)
+{
+	scope s(*this);
+	step_scope steps(_steps, _step_budget);
+	++_evaluations;
+	try
+	{
+		return lisk::eval_string(source, _env);
+	}
+	catch (const std::bad_alloc &)
+	{
+		return out_of_memory(_arena);
+	}
+}
+
+lisk::runtime_stats lisk::runtime::stats() const
+{
+	lisk::runtime_stats result = {
+	  .nodes          = _arena.stats(),
+	  .bytes_reserved = _arena.bytes_reserved(),
+	  .evaluations    = _evaluations,
+	  .steps          = _steps,
+	};
+	for (const auto &arena : _worker_arenas)
+	{
+		add(result.nodes, arena.stats());
+		result.bytes_reserved += arena.bytes_reserved();
+	}
+	return result;
+}
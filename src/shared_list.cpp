@@ -0,0 +1,58 @@
+#include "lisk/shared_list.hpp"
+
+#include <algorithm>
+
+namespace
+{
+	thread_local bool defer_release = false;
+
+	lak::vector<lisk::impl::release_queue_base *> &release_queues()
+	{
+		thread_local lak::vector<lisk::impl::release_queue_base *> queues;
+		return queues;
+	}
+}
+
+void lisk::set_deferred_release(bool defer)
+{
+	defer_release = defer;
+}
+
+bool lisk::deferred_release()
+{
+	return defer_release;
+}
+
+size_t lisk::release_deferred(size_t max_nodes)
+{
+	// Releasing from one queue can fill another (a frame's map holding lists
+	// for example), so keep going until a pass releases nothing.
+	for (bool progress = true; progress && max_nodes > 0;)
+	{
+		progress = false;
+		for (auto *queue : release_queues())
+		{
+			if (queue->releasing || queue->pending() == 0) continue;
+			const size_t released = queue->release(max_nodes);
+			max_nodes -= std::min(max_nodes, released);
+			progress = true;
+		}
+	}
+
+	size_t pending = 0;
+	for (const auto *queue : release_queues()) pending += queue->pending();
+	return pending;
+}
+
+void lisk::impl::register_release_queue(lisk::impl::release_queue_base *queue)
+{
+	release_queues().push_back(queue);
+}
+
+void lisk::impl::unregister_release_queue(
+  lisk::impl::release_queue_base *queue)
+{
+	auto &queues = release_queues();
+	queues.erase(std::remove(queues.begin(), queues.end(), queue),
+	             queues.end());
+}
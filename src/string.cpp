@@ -3,9 +3,71 @@
 #include "lisk/atom.hpp"
 #include "lisk/expression.hpp"
 
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace
+{
+	struct symbol_table
+	{
+		std::shared_mutex mutex;
+		// std::deque never moves its elements, so the string_view keys and the
+		// references handed out by symbol::name stay valid as the table grows.
+		std::deque<lisk::string> names;
+		std::unordered_map<std::string_view, lisk::symbol::id_type> ids;
+
+		symbol_table() { intern(""); }
+
+		lisk::symbol::id_type intern(std::string_view name)
+		{
+			{
+				std::shared_lock lock(mutex);
+				if (const auto it = ids.find(name); it != ids.end())
+					return it->second;
+			}
+
+			std::unique_lock lock(mutex);
+			if (const auto it = ids.find(name); it != ids.end()) return it->second;
+
+			// Ids would wrap around and alias existing symbols.
+			if (names.size() >
+			    std::numeric_limits<lisk::symbol::id_type>::max())
+				throw std::length_error("Too many symbols for a symbol id");
+
+			const auto id = static_cast<lisk::symbol::id_type>(names.size());
+			names.emplace_back(lak::astring(name));
+			ids.emplace(std::string_view(names.back()), id);
+			return id;
+		}
+
+		const lisk::string &name(lisk::symbol::id_type id)
+		{
+			std::shared_lock lock(mutex);
+			return names[id];
+		}
+	};
+
+	symbol_table &symbols()
+	{
+		static symbol_table table;
+		return table;
+	}
+}
+
+lisk::symbol::symbol(std::string_view value) : id(symbols().intern(value)) {}
+
+const lisk::string &lisk::symbol::name() const
+{
+	return symbols().name(id);
+}
+
 lisk::string lisk::to_string(const lisk::symbol &sym)
 {
-	return sym;
+	return sym.name();
 }
 
 const lisk::string &lisk::type_name(const lisk::symbol &)
@@ -14,6 +76,17 @@ const lisk::string &lisk::type_name(const lisk::symbol &)
 	return name;
 }
 
+lisk::string lisk::to_string(const lisk::resolved_symbol &sym)
+{
+	return sym.sym.name();
+}
+
+const lisk::string &lisk::type_name(const lisk::resolved_symbol &)
+{
+	const static lisk::string name = "symbol";
+	return name;
+}
+
 lisk::string lisk::to_string(const lisk::string &str)
 {
 	auto result  = str;
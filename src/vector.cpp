@@ -0,0 +1,190 @@
+#include "lisk/vector.hpp"
+
+#include "lisk/expression.hpp"
+#include "lisk/shared_list.hpp"
+
+namespace
+{
+	constexpr size_t bits  = lisk::vector::bits;
+	constexpr size_t width = lisk::vector::width;
+	constexpr size_t mask  = width - 1;
+
+	using leaf_ptr   = lisk::node_ptr<lisk::vector_leaf>;
+	using branch_ptr = lisk::node_ptr<lisk::vector_branch>;
+
+	// Make node safe to modify, copying it if anything else refers to it.
+	// Copying a node shares its children, so modifying a path through the trie
+	// copies exactly the shared nodes on that path.
+	template<typename T>
+	T &writable(lisk::node_ptr<T> &node)
+	{
+		if (!node)
+			node = lisk::node_ptr<T>::make();
+		else if (node.use_count() != 1)
+			node = lisk::node_ptr<T>::make(*node);
+		return *node;
+	}
+
+	// A branch at level with leaf as its only descendant.
+	branch_ptr new_path(size_t level, leaf_ptr leaf)
+	{
+		auto branch = branch_ptr::make();
+		if (level == bits)
+			branch->leaves[0] = lak::move(leaf);
+		else
+			branch->branches[0] = new_path(level - bits, lak::move(leaf));
+		return branch;
+	}
+
+	// Insert a full tail leaf whose last element is at index.
+	void push_tail(branch_ptr &node, size_t level, size_t index, leaf_ptr leaf)
+	{
+		auto &branch   = writable(node);
+		const size_t i = (index >> level) & mask;
+		if (level == bits)
+			branch.leaves[i] = lak::move(leaf);
+		else if (branch.branches[i])
+			push_tail(branch.branches[i], level - bits, index, lak::move(leaf));
+		else
+			branch.branches[i] = new_path(level - bits, lak::move(leaf));
+	}
+
+	void push_data(lisk::vector_data &data, lisk::expression value)
+	{
+		if (const size_t in_tail = data.count - data.tail_offset(); in_tail < width)
+		{
+			writable(data.tail).values[in_tail] = lak::move(value);
+			++data.count;
+			return;
+		}
+
+		// The tail is full, move it into the trie and start a new one.
+		leaf_ptr full_tail = lak::move(data.tail);
+		if (!data.root)
+		{
+			data.root = new_path(bits, lak::move(full_tail));
+		}
+		else if ((data.count >> bits) > (size_t(1) << data.shift))
+		{
+			// The trie is full, add a level above the root.
+			auto root          = branch_ptr::make();
+			root->branches[0]  = lak::move(data.root);
+			root->branches[1]  = new_path(data.shift, lak::move(full_tail));
+			data.root          = lak::move(root);
+			data.shift        += bits;
+		}
+		else
+		{
+			push_tail(data.root, data.shift, data.count - 1, lak::move(full_tail));
+		}
+
+		writable(data.tail).values[0] = lak::move(value);
+		++data.count;
+	}
+
+	void set_data(lisk::vector_data &data, size_t index, lisk::expression value)
+	{
+		if (index >= data.tail_offset())
+		{
+			writable(data.tail).values[index & mask] = lak::move(value);
+			return;
+		}
+
+		branch_ptr *node = &data.root;
+		for (size_t level = data.shift; level > bits; level -= bits)
+			node = &writable(*node).branches[(index >> level) & mask];
+		writable(writable(*node).leaves[(index >> bits) & mask])
+		  .values[index & mask] = lak::move(value);
+	}
+}
+
+lisk::vector_leaf::~vector_leaf()
+{
+	auto *queue = lisk::impl::release_queue<lisk::expression>::get();
+	// The thread is exiting, fall back to recursive destruction.
+	if (!queue) return;
+
+	bool released = false;
+	for (auto &value : values)
+	{
+		if (value.owns_nodes())
+		{
+			queue->values.push_back(lak::move(value));
+			released = true;
+		}
+	}
+
+	if (released && !queue->releasing && !lisk::deferred_release())
+		queue->release(SIZE_MAX);
+}
+
+lak::result<const lisk::expression &> lisk::vector::at(size_t index) const
+{
+	if (index >= _size) return lak::err_t{};
+	return lak::result_from_pointer(&(*this)[index]);
+}
+
+void lisk::vector::push_back(lisk::expression value)
+{
+	auto &data = writable(_data);
+	// A slice that ends before its data does overwrites the next element
+	// instead, which copies it if the data is shared.
+	if (_offset + _size == data.count)
+		push_data(data, lak::move(value));
+	else
+		set_data(data, _offset + _size, lak::move(value));
+	++_size;
+}
+
+void lisk::vector::set(size_t index, lisk::expression value)
+{
+	set_data(writable(_data), _offset + index, lak::move(value));
+}
+
+lisk::vector lisk::vector::slice(size_t begin, size_t end) const
+{
+	if (begin >= end) return {};
+	lisk::vector result = *this;
+	result._offset += begin;
+	result._size    = end - begin;
+	return result;
+}
+
+const lisk::expression *lisk::vector::leaf(size_t index) const
+{
+	const auto &data = *_data;
+	if (index >= data.tail_offset()) return data.tail->values;
+
+	const lisk::vector_branch *node = data.root.get();
+	for (size_t level = data.shift; level > bits; level -= bits)
+		node = node->branches[(index >> level) & mask].get();
+	return node->leaves[(index >> bits) & mask]->values;
+}
+
+lisk::string lisk::to_string(const lisk::vector &v)
+{
+	lisk::string result = "[";
+	for (auto it = v.begin(); it != v.end(); ++it)
+	{
+		if (it._index != 0) result += " ";
+		result += to_string(*it);
+	}
+	return result + "]";
+}
+
+const lisk::string &lisk::type_name(const lisk::vector &)
+{
+	const static lisk::string name = "vector";
+	return name;
+}
+
+bool operator>>(const lisk::expression &arg, lisk::vector &out)
+{
+	if_let_ok (const auto &v, arg.get_vector())
+	{
+		out = v;
+		return true;
+	}
+	else
+		return false;
+}
@@ -0,0 +1,213 @@
+#include "lisk/worker_pool.hpp"
+
+#include "lisk/eval.hpp"
+
+#include <algorithm>
+#include <utility>
+
+#if !defined(_WIN32)
+#	include <pthread.h>
+#endif
+
+namespace
+{
+	// The pool whose worker thread this is, and the index of its queue.
+	thread_local const lisk::worker_pool *worker_of = nullptr;
+	thread_local size_t worker_index                = 0;
+
+	thread_local lisk::worker_pool *current_pool = nullptr;
+
+	// The size of this thread's stack, or 0 if it isn't known. Windows threads
+	// get the same 1MiB stack as the main thread, which the default stack
+	// budget already allows for.
+	size_t thread_stack_size()
+	{
+#if defined(__APPLE__)
+		return pthread_get_stacksize_np(pthread_self());
+#elif defined(__linux__)
+		pthread_attr_t attr;
+		if (pthread_getattr_np(pthread_self(), &attr) != 0) return 0;
+		size_t size = 0;
+		if (pthread_attr_getstacksize(&attr, &size) != 0) size = 0;
+		pthread_attr_destroy(&attr);
+		return size;
+#else
+		return 0;
+#endif
+	}
+}
+
+lisk::worker_pool::worker_pool(size_t threads,
+                               thread_init init,
+                               void *init_context)
+: _init(init), _init_context(init_context)
+{
+	threads = thread_count(threads);
+
+	_concurrency = threads;
+	_queues      = std::make_unique<queue[]>(threads);
+	_threads.reserve(threads - 1);
+	for (size_t i = 0; i + 1 < threads; ++i)
+		_threads.emplace_back([this, i] { work(i); });
+}
+
+lisk::worker_pool::~worker_pool()
+{
+	{
+		std::lock_guard lock(_sleep_mutex);
+		_stopping = true;
+	}
+	_wake.notify_all();
+	for (auto &thread : _threads) thread.join();
+}
+
+size_t lisk::worker_pool::thread_count(size_t threads)
+{
+#ifdef LISK_SINGLE_THREADED
+	return 1;
+#else
+	if (threads == 0) threads = std::thread::hardware_concurrency();
+	return threads == 0 ? 1 : threads;
+#endif
+}
+
+void lisk::worker_pool::run(batch &b, size_t count, size_t grain)
+{
+	const size_t chunks = (count + grain - 1) / grain;
+	const size_t queues = concurrency();
+	const size_t home = worker_of == this ? worker_index : queues - 1;
+
+	b.pending.store(chunks, std::memory_order_relaxed);
+	// Counted before they're queued, so taking a task never takes the count
+	// below zero.
+	if (_concurrency > 1) _queued.fetch_add(chunks, std::memory_order_release);
+
+	// Hand each queue a contiguous run of chunks, starting with this thread's
+	// own queue, so workers only steal once they run out.
+	for (size_t q = 0; q < queues; ++q)
+	{
+		const size_t first = chunks * q / queues;
+		const size_t last  = chunks * (q + 1) / queues;
+		if (first == last) continue;
+
+		auto &target = _queues[(home + q) % queues];
+		std::lock_guard lock(target.mutex);
+		for (size_t c = first; c < last; ++c)
+			target.tasks.push_back(
+			  task{&b, c * grain, c + 1 == chunks ? count : (c + 1) * grain});
+	}
+
+	if (_concurrency > 1)
+	{
+		// Taking the lock orders this with workers checking _queued before
+		// they go to sleep.
+		{
+			std::lock_guard lock(_sleep_mutex);
+		}
+		_wake.notify_all();
+	}
+
+	while (b.pending.load(std::memory_order_acquire) != 0)
+	{
+		if (run_one(home)) continue;
+
+		// Every task of the batch has been taken, so the rest are running on
+		// other threads.
+		std::unique_lock lock(b.done_mutex);
+		b.done.wait(
+		  lock, [&] { return b.pending.load(std::memory_order_acquire) == 0; });
+	}
+	// The thread that finished the last task may still be notifying.
+	std::lock_guard lock(b.done_mutex);
+
+	if (b.error) std::rethrow_exception(b.error);
+}
+
+bool lisk::worker_pool::run_one(size_t index)
+{
+	const size_t queues = concurrency();
+
+	task t;
+	bool found = false;
+	{
+		auto &own = _queues[index];
+		std::lock_guard lock(own.mutex);
+		if (!own.tasks.empty())
+		{
+			t = own.tasks.back();
+			own.tasks.pop_back();
+			found = true;
+		}
+	}
+	for (size_t i = 1; !found && i < queues; ++i)
+	{
+		auto &other = _queues[(index + i) % queues];
+		std::lock_guard lock(other.mutex);
+		if (!other.tasks.empty())
+		{
+			t = other.tasks.front();
+			other.tasks.pop_front();
+			found = true;
+		}
+	}
+	if (!found) return false;
+
+	if (_concurrency > 1) _queued.fetch_sub(1, std::memory_order_relaxed);
+
+	batch &b = *t.owner;
+	try
+	{
+		b.call(b.context, t.begin, t.end);
+	}
+	catch (...)
+	{
+		std::lock_guard lock(b.error_mutex);
+		if (!b.error) b.error = std::current_exception();
+	}
+	// b may be destroyed as soon as this reaches 0 and the lock is released.
+	std::lock_guard lock(b.done_mutex);
+	if (b.pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+		b.done.notify_all();
+	return true;
+}
+
+void lisk::worker_pool::work(size_t index)
+{
+	worker_of    = this;
+	worker_index = index;
+	// Secondary threads can have much smaller stacks than the main thread
+	// (512KiB on macOS), leave a quarter of it for the frames below eval like
+	// the default budget does.
+	if (const size_t size = thread_stack_size(); size != 0)
+		lisk::set_eval_stack_budget(
+		  std::min(lisk::eval_stack_budget(), size / 4 * 3));
+	// Batches started by tasks run on the same pool.
+	current_pool = this;
+	if (_init) _init(_init_context, index);
+
+	for (;;)
+	{
+		if (run_one(index)) continue;
+
+		std::unique_lock lock(_sleep_mutex);
+		_wake.wait(lock,
+		           [&]
+		           {
+			           return _stopping ||
+			                  _queued.load(std::memory_order_acquire) != 0;
+		           });
+		if (_stopping && _queued.load(std::memory_order_acquire) == 0) return;
+	}
+}
+
+lisk::worker_pool *lisk::set_worker_pool(lisk::worker_pool *pool)
+{
+	return std::exchange(current_pool, pool);
+}
+
+lisk::worker_pool &lisk::get_worker_pool()
+{
+	if (current_pool) return *current_pool;
+	static lisk::worker_pool pool;
+	return pool;
+}